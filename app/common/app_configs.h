@@ -17,17 +17,24 @@ static const int CONNECTOR_RADIUS = 5;
 static const qreal MINIMUM_NODE_SIZE = 50;
 static const qreal OPACITY_THRESHOLD = 0.25;
 
+// Bytes of undo history kept per canvas
+static const qsizetype UNDO_MEMORY_BUDGET = 16 * 1024 * 1024;
+
 }  // namespace Config
 
 namespace Constants
 {
 static const QString TMP_CONNECTION_ID = QStringLiteral("tmp_id");
 static const QString TYPE_NODE = QStringLiteral("application/x-node");
+static const QString TYPE_NODES = QStringLiteral("application/x-maki-nodes");
 static const QString TYPE_PIXMAP = QStringLiteral("application/x-pixmap");
 static const QString TYPE_CONFIG = QStringLiteral("application/x-configuration");
 static const QString TYPE_NODE_ID = QStringLiteral("application/x-node-id");
 
 static const qreal CONTROL_POINT_SHIFT = 100;
+
+// Read by Qt WebEngine, set for our own web views and kept from the processes we start
+static const char* const CHROMIUM_FLAGS_ENV = "QTWEBENGINE_CHROMIUM_FLAGS";
 }  // namespace Constants
 
 class Fonts
@@ -252,6 +252,17 @@ NodeConfig::NodeConfig(const QJsonObject& object)
   }
 }
 
+void NodeConfig::buildDefaults()
+{
+  defaultProperties.clear();
+  for (const auto& property : properties)
+    defaultProperties.insert(property.id, property.defaultValue);
+
+  eventNames.clear();
+  for (const auto& event : events)
+    eventNames.insert(event.name);
+}
+
 // ===========================================================================================================
 // NodeConfig
 QDataStream& operator<<(QDataStream& out, const NodeConfig& config)
@@ -281,6 +292,8 @@ QDataStream& operator>>(QDataStream& in, NodeConfig& config)
   in >> config.events;
   in >> config.transitions;
 
+  config.buildDefaults();
+
   return in;
 }
 
@@ -304,6 +317,17 @@ QDataStream& operator<<(QDataStream& out, const BodyConfig& config)
 
 QDataStream& operator>>(QDataStream& in, BodyConfig& config)
 {
+  in >> config.shape;
+  in >> config.textColor;
+  in >> config.backgroundColor;
+  in >> config.borderColor;
+  in >> config.width;
+  in >> config.height;
+  in >> config.zIndex;
+  in >> config.borderRadius;
+  in >> config.iconPath;
+  in >> config.iconScale;
+
   return in;
 }
 
@@ -318,6 +342,8 @@ QDataStream& operator<<(QDataStream& out, const HelpConfig& config)
 
 QDataStream& operator>>(QDataStream& in, HelpConfig& config)
 {
+  in >> config.message;
+
   return in;
 }
 
@@ -332,6 +358,8 @@ QDataStream& operator<<(QDataStream& out, const BehaviourConfig& config)
 
 QDataStream& operator>>(QDataStream& in, BehaviourConfig& config)
 {
+  in >> config.code;
+
   return in;
 }
 
@@ -348,6 +376,10 @@ QDataStream& operator<<(QDataStream& out, const ControlsConfig& config)
 
 QDataStream& operator>>(QDataStream& in, ControlsConfig& config)
 {
+  in >> config.id;
+  in >> config.type;
+  in >> config.format;
+
   return in;
 }
 
@@ -359,12 +391,19 @@ QDataStream& operator<<(QDataStream& out, const FlowConfig& config)
   out << config.type;
   out << config.returnType;
   out << config.arguments;
+  out << config.modifiable;
 
   return out;
 }
 
 QDataStream& operator>>(QDataStream& in, FlowConfig& config)
 {
+  in >> config.name;
+  in >> config.type;
+  in >> config.returnType;
+  in >> config.arguments;
+  in >> config.modifiable;
+
   return in;
 }
 
@@ -381,5 +420,9 @@ QDataStream& operator<<(QDataStream& out, const TransitionConfig& config)
 
 QDataStream& operator>>(QDataStream& in, TransitionConfig& config)
 {
+  in >> config.id;
+  in >> config.label;
+  in >> config.modifiable;
+
   return in;
 }
@@ -2,11 +2,15 @@
 
 #include <QColor>
 #include <QJsonObject>
+#include <QMap>
+#include <QSet>
 #include <QString>
+#include <QVariant>
 #include <QVector>
 
 #include "config_base.h"
 #include "property_config.h"
+#include "symbol.h"
 #include "types.h"
 
 class TransitionConfig : public ConfigBase
@@ -121,6 +125,15 @@ public:
 
   Types::LibraryTypes libraryType = Types::LibraryTypes::UNKNOWN;
 
+  // Key in the configuration table, set when the node type is registered
+  Symbol key;
+
+  // Filled in by buildDefaults, every new node of this type starts from these
+  QMap<QString, QVariant> defaultProperties;
+  QSet<QString> eventNames;
+
+  void buildDefaults();
+
   friend QDataStream& operator<<(QDataStream& out, const NodeConfig& config);
   friend QDataStream& operator>>(QDataStream& in, NodeConfig& config);
 };
@@ -6,6 +6,8 @@
 #include "property_config.h"
 #include "types.h"
 
+// Containers are returned by reference and are only valid until the node is
+// modified, copy them before adding or removing anything while iterating
 class INode
 {
 public:
@@ -13,15 +15,15 @@ public:
 
   virtual QString nodeName() const = 0;
   virtual QString nodeType() const = 0;
-  virtual QMap<QString, QVariant> properties() const = 0;
+  virtual const QMap<QString, QVariant>& properties() const = 0;
 
   virtual Types::LibraryTypes function() const = 0;
 
   virtual QVariant getProperty(const QString& key) const = 0;
 
-  virtual QVector<PropertiesConfig> fields() const = 0;
+  virtual const QVector<PropertiesConfig>& fields() const = 0;
   virtual PropertiesConfig getField(const QString& key) const = 0;
 
   virtual INode* parentNode() const = 0;
-  virtual QVector<INode*> children() const = 0;
+  virtual const QVector<INode*>& children() const = 0;
 };
@@ -1,14 +1,44 @@
 #include "process_runner.h"
 
 #include <QByteArray>
+#include <QDeadlineTimer>
 #include <QProcess>
+#include <QStringDecoder>
+#include <QTimer>
+#include <memory>
 
+#include "app_configs.h"
 #include "logging.h"
 
+// Time given to a cancelled process to exit before it is killed
+static const int KILL_GRACE_MS = 3000;
+// Time the destructor waits for all the killed processes together
+static const int KILL_WAIT_MS = 1000;
+
 ProcessRunner::ProcessRunner(QObject* parent)
-    : mCwd("")
+    : QObject(parent)
+    , mEnv(QProcessEnvironment::systemEnvironment())
+    , mCwd("")
     , mTimeout(-1)
+    , mNextJob(1)
+{
+  // The Chromium flags are meant for the editor's own web views only
+  mEnv.remove(Constants::CHROMIUM_FLAGS_ENV);
+}
+
+ProcessRunner::~ProcessRunner()
 {
+  // Nobody is left to hear about these jobs. They are all killed before any is
+  // waited for, so the GUI thread waits at most once for the slowest of them
+  for (QProcess* proc : mJobs)
+  {
+    disconnect(proc, nullptr, this, nullptr);
+    proc->kill();
+  }
+
+  QDeadlineTimer deadline(KILL_WAIT_MS);
+  for (QProcess* proc : mJobs)
+    proc->waitForFinished(qMax(qint64(0), deadline.remainingTime()));
 }
 
 void ProcessRunner::addEnvVariable(const QString& key, const QString& value)
@@ -16,10 +46,9 @@ void ProcessRunner::addEnvVariable(const QString& key, const QString& value)
   mEnv.insert(key, value);
 }
 
-void ProcessRunner::removeEnvVariable(const QString& key, const QString& value)
+void ProcessRunner::removeEnvVariable(const QString& key)
 {
-  if (mEnv.contains(key))
-    mEnv.remove(key);
+  mEnv.remove(key);
 }
 
 void ProcessRunner::setCwd(const QString& path)
@@ -32,9 +61,17 @@ void ProcessRunner::setTimeout(int ms)
   mTimeout = ms;
 }
 
+void ProcessRunner::configure(QProcess* proc) const
+{
+  proc->setProcessEnvironment(mEnv);
+  if (!mCwd.isEmpty())
+    proc->setWorkingDirectory(mCwd);
+}
+
 int ProcessRunner::runSync(const QString& cmd, QString& result)
 {
   QProcess proc;
+  configure(&proc);
 
   // Merge stdout + stderr so result contains everything
   proc.setProcessChannelMode(QProcess::MergedChannels);
@@ -48,8 +85,7 @@ int ProcessRunner::runSync(const QString& cmd, QString& result)
     return -1;
   }
 
-  // -1 = wait indefinitely; you can add a timeout if you want
-  if (!proc.waitForFinished(-1))
+  if (!proc.waitForFinished(mTimeout))
   {
     LOG_WARNING("Process '%s' did not finish in time", qPrintable(cmd));
     proc.kill();
@@ -74,10 +110,14 @@ int ProcessRunner::runSync(const QString& cmd, QString& result)
   return exitCode;
 }
 
-void ProcessRunner::runAsync(const QString& cmd, FinshedCallback finishedCb, LogCallback stdoutCb, LogCallback stderrCb)
+ProcessRunner::JobId ProcessRunner::runAsync(const QString& cmd, FinshedCallback finishedCb, LogCallback stdoutCb, LogCallback stderrCb)
 {
-  // QProcess must be heap-allocated if we want "self-delete" after finish
+  JobId id = mNextJob++;
+
+  // Owned by the runner until the job is done
   QProcess* proc = new QProcess(this);
+  configure(proc);
+  mJobs.insert(id, proc);
 
   if (stdoutCb || stderrCb)
     proc->setProcessChannelMode(QProcess::SeparateChannels);
@@ -85,38 +125,116 @@ void ProcessRunner::runAsync(const QString& cmd, FinshedCallback finishedCb, Log
     proc->setProcessChannelMode(QProcess::MergedChannels);
 
   QObject::connect(proc, &QProcess::finished, this,
-                   [proc, finishedCb](int exitCode, QProcess::ExitStatus status) {
+                   [this, id, proc, finishedCb](int exitCode, QProcess::ExitStatus status) {
                      QString output = QString(proc->readAll());
 
-                     // Use -1 or a special value to indicate crash
-                     if (status == QProcess::CrashExit)
+                     // Use -1 or a special value to indicate crash. Cancelled and
+                     // timed out jobs are reported as failed whatever the exit code
+                     if (status == QProcess::CrashExit || mAborted.contains(id))
                        exitCode = -1;
 
+                     finishJob(id, exitCode);
                      if (finishedCb)
                        finishedCb(exitCode, output);
-
-                     proc->deleteLater();
                    });
 
+  // The other errors are followed by finished
+  QObject::connect(proc, &QProcess::errorOccurred, this, [this, id, proc, cmd, finishedCb](QProcess::ProcessError error) {
+    if (error != QProcess::FailedToStart)
+      return;
+
+    LOG_ERROR("Failed to start process: %s", qPrintable(cmd));
+
+    QString message = proc->errorString();
+    finishJob(id, -1);
+    if (finishedCb)
+      finishedCb(-1, message);
+  });
+
+  // Decoders keep characters that were split between two reads
   if (stdoutCb)
   {
-    QObject::connect(proc, &QProcess::readyReadStandardOutput, this, [proc, stdoutCb]() {
-      QString output = QString(proc->readAllStandardOutput());
-      if (stdoutCb)
+    auto decoder = std::make_shared<QStringDecoder>(QStringDecoder::System);
+    QObject::connect(proc, &QProcess::readyReadStandardOutput, this, [proc, decoder, stdoutCb]() {
+      QString output = decoder->decode(proc->readAllStandardOutput());
+      if (!output.isEmpty())
         stdoutCb(output);
     });
   }
 
   if (stderrCb)
   {
-    QObject::connect(proc, &QProcess::readyReadStandardError, this, [proc, stderrCb]() {
-      QString output = QString(proc->readAllStandardError());
-      if (stderrCb)
+    auto decoder = std::make_shared<QStringDecoder>(QStringDecoder::System);
+    QObject::connect(proc, &QProcess::readyReadStandardError, this, [proc, decoder, stderrCb]() {
+      QString output = decoder->decode(proc->readAllStandardError());
+      if (!output.isEmpty())
         stderrCb(output);
     });
   }
 
+  if (mTimeout >= 0)
+  {
+    QTimer::singleShot(mTimeout, proc, [this, id, proc, cmd]() {
+      // The job may have finished while the process waits to be deleted
+      if (!mJobs.contains(id))
+        return;
+
+      LOG_WARNING("Process '%s' did not finish in time", qPrintable(cmd));
+      mAborted.insert(id);
+      stop(proc);
+    });
+  }
+
   proc->startCommand(cmd);
+
+  return id;
+}
+
+void ProcessRunner::cancel(JobId id)
+{
+  QProcess* proc = mJobs.value(id, nullptr);
+  if (!proc)
+    return;
+
+  LOG_DEBUG("Cancelling process job %llu", static_cast<unsigned long long>(id));
+
+  mAborted.insert(id);
+  stop(proc);
+}
+
+void ProcessRunner::cancelAll()
+{
+  for (JobId id : mJobs.keys())
+    cancel(id);
+}
+
+bool ProcessRunner::isRunning(JobId id) const
+{
+  return mJobs.contains(id);
+}
+
+void ProcessRunner::stop(QProcess* proc)
+{
+  if (proc->state() == QProcess::NotRunning)
+    return;
+
+  // Ask nicely first, give it some time and then kill it
+  proc->terminate();
+  QTimer::singleShot(KILL_GRACE_MS, proc, [proc]() {
+    if (proc->state() != QProcess::NotRunning)
+      proc->kill();
+  });
+}
+
+void ProcessRunner::finishJob(JobId id, int exitCode)
+{
+  mAborted.remove(id);
+
+  QProcess* proc = mJobs.take(id);
+  if (proc)
+    proc->deleteLater();
+
+  LOG_DEBUG("Process job %llu finished with code %d", static_cast<unsigned long long>(id), exitCode);
 }
 
 int ProcessRunner::ExecuteSync(const QString& cmd, QString& result)
@@ -125,8 +243,18 @@ int ProcessRunner::ExecuteSync(const QString& cmd, QString& result)
   return runner.runSync(cmd, result);
 }
 
-void ProcessRunner::ExecuteAsync(const QString& cmd, QObject* parent, FinshedCallback finishedCb, LogCallback stdoutCb, LogCallback stderrCb)
+ProcessRunner* ProcessRunner::ExecuteAsync(const QString& cmd, QObject* parent, FinshedCallback finishedCb, LogCallback stdoutCb, LogCallback stderrCb)
 {
-  ProcessRunner runner(parent);
-  runner.runAsync(cmd, finishedCb, stdoutCb, stderrCb);
-}
\ No newline at end of file
+  // Must outlive the process, so it cleans itself up once the job is done
+  ProcessRunner* runner = new ProcessRunner(parent);
+  runner->runAsync(
+      cmd, [runner, finishedCb](int exitCode, const QString& output) {
+        if (finishedCb)
+          finishedCb(exitCode, output);
+
+        runner->deleteLater();
+      },
+      stdoutCb, stderrCb);
+
+  return runner;
+}
@@ -1,33 +1,62 @@
 #pragma once
 
+#include <QHash>
 #include <QObject>
 #include <QProcessEnvironment>
+#include <QSet>
 #include <QString>
+#include <functional>
 
+class QProcess;
+
+// Runs shell commands with the configured environment, working directory and
+// timeout. Asynchronous jobs are owned by the runner, so it has to outlive
+// them; destroying it kills whatever is still running.
 class ProcessRunner : public QObject
 {
   Q_OBJECT
 public:
   ProcessRunner(QObject* parent = nullptr);
+  ~ProcessRunner();
 
+  // Starts from the environment of the application
   void addEnvVariable(const QString& key, const QString& value);
-  void removeEnvVariable(const QString& key, const QString& value);
+  void removeEnvVariable(const QString& key);
 
   void setCwd(const QString& path);
+  // -1 waits forever
   void setTimeout(int ms);
 
   using FinshedCallback = std::function<void(int, const QString&)>;
   using LogCallback = std::function<void(const QString&)>;
+  using JobId = quint64;
 
   int runSync(const QString& cmd, QString& result);
-  void runAsync(const QString& cmd, FinshedCallback finishedCb, LogCallback stdoutCb = nullptr, LogCallback stderrCb = nullptr);
+
+  // Output is handed to the log callbacks as it arrives, the finished callback
+  // then gets whatever was not streamed. Cancelled, crashed and timed out jobs
+  // finish with -1.
+  JobId runAsync(const QString& cmd, FinshedCallback finishedCb, LogCallback stdoutCb = nullptr, LogCallback stderrCb = nullptr);
+  void cancel(JobId id);
+  void cancelAll();
+  bool isRunning(JobId id) const;
 
   static int ExecuteSync(const QString& cmd, QString& result);
-  static void ExecuteAsync(const QString& cmd, QObject* parent,
-                           FinshedCallback finishedCb, LogCallback stdoutCb = nullptr, LogCallback stderrCb = nullptr);
+  // The runner lives until the job finishes, it can be used to cancel it
+  static ProcessRunner* ExecuteAsync(const QString& cmd, QObject* parent,
+                                     FinshedCallback finishedCb, LogCallback stdoutCb = nullptr, LogCallback stderrCb = nullptr);
 
 private:
   QProcessEnvironment mEnv;
   QString mCwd;
   int mTimeout;
+
+  JobId mNextJob;
+  QHash<JobId, QProcess*> mJobs;
+  // Cancelled or timed out
+  QSet<JobId> mAborted;
+
+  void configure(QProcess* proc) const;
+  void finishJob(JobId id, int exitCode);
+  void stop(QProcess* proc);
 };
@@ -7,6 +7,7 @@
 #include <QJsonArray>
 
 #include "keys.h"
+#include "symbol.h"
 #include "types.h"
 
 PropertiesConfig::PropertiesConfig()
@@ -31,7 +32,7 @@ PropertiesConfig::PropertiesConfig(const QJsonObject& object)
     return;
   }
 
-  id = object["id"].toString();
+  id = Symbol::canonical(object["id"].toString());
   type = Types::StringToPropertyTypes(object["type"].toString());
   if (type == Types::PropertyTypes::UNKNOWN)
   {
@@ -167,7 +168,7 @@ QJsonObject PropertiesConfig::toJson() const
 PropertiesConfig PropertiesConfig::fromJson(const QJsonObject& data)
 {
   PropertiesConfig config;
-  config.id = data[ConfigKeys::ID].toString();
+  config.id = Symbol::canonical(data[ConfigKeys::ID].toString());
   config.defaultValue = QJsonValue(data[ConfigKeys::DEFAULT]).toVariant();
 
   for (const auto& value : data[ConfigKeys::OPTIONS].toArray())
@@ -193,6 +194,7 @@ QDataStream& operator<<(QDataStream& out, const PropertiesConfig& config)
 QDataStream& operator>>(QDataStream& in, PropertiesConfig& config)
 {
   in >> config.id;
+  config.id = Symbol::canonical(config.id);
   in >> config.type;
   in >> config.options;
   in >> config.defaultValue;
@@ -0,0 +1,139 @@
+#include "symbol.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <array>
+#include <atomic>
+
+namespace
+{
+// Names are stored in fixed chunks that never move, so reading one back from a
+// handle needs no lock
+const quint32 CHUNK_SIZE = 1024;
+const quint32 MAX_CHUNKS = 4096;
+
+// Handle 0 is the invalid symbol
+struct SymbolTable
+{
+  // Only guards the handle lookup and the growth of the chunks
+  QReadWriteLock lock;
+  QHash<QString, quint32> handles;
+  quint32 count = 1;
+
+  std::array<std::atomic<QString*>, MAX_CHUNKS> chunks{};
+
+  SymbolTable()
+  {
+    chunks[0].store(new QString[CHUNK_SIZE], std::memory_order_release);
+  }
+
+  const QString& name(quint32 handle) const
+  {
+    return chunks[handle / CHUNK_SIZE].load(std::memory_order_acquire)[handle % CHUNK_SIZE];
+  }
+
+  // Called with the write lock held
+  quint32 add(const QString& name)
+  {
+    quint32 handle = count;
+    auto& chunk = chunks[handle / CHUNK_SIZE];
+    if (!chunk.load(std::memory_order_relaxed))
+      chunk.store(new QString[CHUNK_SIZE], std::memory_order_release);
+
+    chunk.load(std::memory_order_relaxed)[handle % CHUNK_SIZE] = name;
+    handles.insert(name, handle);
+    ++count;
+
+    return handle;
+  }
+};
+
+SymbolTable& table()
+{
+  static SymbolTable instance;
+  return instance;
+}
+}  // namespace
+
+Symbol::Symbol()
+    : mHandle(0)
+{
+}
+
+Symbol::Symbol(const QString& name)
+    : mHandle(0)
+{
+  if (name.isEmpty())
+    return;
+
+  SymbolTable& symbols = table();
+  {
+    QReadLocker locker(&symbols.lock);
+    mHandle = symbols.handles.value(name, 0);
+  }
+
+  if (mHandle != 0)
+    return;
+
+  // Someone may have added it in between, so look again with the write lock
+  QWriteLocker locker(&symbols.lock);
+  mHandle = symbols.handles.value(name, 0);
+  if (mHandle != 0)
+    return;
+
+  Q_ASSERT(symbols.count < CHUNK_SIZE * MAX_CHUNKS);
+  mHandle = symbols.add(name);
+}
+
+Symbol Symbol::find(const QString& name)
+{
+  SymbolTable& symbols = table();
+  QReadLocker locker(&symbols.lock);
+
+  Symbol symbol;
+  symbol.mHandle = symbols.handles.value(name, 0);
+  return symbol;
+}
+
+QString Symbol::canonical(const QString& name)
+{
+  if (name.isEmpty())
+    return name;
+
+  return Symbol(name).toString();
+}
+
+bool Symbol::isValid() const
+{
+  return mHandle != 0;
+}
+
+quint32 Symbol::handle() const
+{
+  return mHandle;
+}
+
+const QString& Symbol::toString() const
+{
+  return table().name(mHandle);
+}
+
+bool Symbol::operator==(const Symbol& other) const
+{
+  return mHandle == other.mHandle;
+}
+
+bool Symbol::operator!=(const Symbol& other) const
+{
+  return mHandle != other.mHandle;
+}
+
+bool Symbol::operator<(const Symbol& other) const
+{
+  return mHandle < other.mHandle;
+}
+
+size_t qHash(const Symbol& symbol, size_t seed)
+{
+  return qHash(symbol.handle(), seed);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QHashFunctions>
+#include <QString>
+
+// Interned string that is compared and hashed as an integer handle.
+// Library type ids and property keys repeat on every node, with a symbol they
+// are stored once and the copies on the nodes share the canonical string.
+//
+// The table lives in libcommon, which is linked statically, so handles must
+// not be passed to plugins. Plugins only ever see the strings.
+class Symbol
+{
+public:
+  Symbol();
+  explicit Symbol(const QString& name);
+
+  // Does not add the name to the table, the symbol is invalid if it is unknown.
+  // Takes the table lock, hot paths should keep the symbol instead.
+  static Symbol find(const QString& name);
+  // Shares the data of the canonical string, so that equal strings are only allocated once
+  static QString canonical(const QString& name);
+
+  bool isValid() const;
+  quint32 handle() const;
+  // Lock free, the names never move once added
+  const QString& toString() const;
+
+  bool operator==(const Symbol& other) const;
+  bool operator!=(const Symbol& other) const;
+  bool operator<(const Symbol& other) const;
+
+private:
+  quint32 mHandle;
+};
+
+size_t qHash(const Symbol& symbol, size_t seed = 0);
@@ -25,19 +25,55 @@ QString loadFile(const QString& path)
   return QString::fromUtf8(f.readAll());
 }
 
-QString applyThemeVars(QString qss, const ThemeVars& t)
+static bool isIdentifierChar(QChar c)
 {
-  for (auto it = THEME_KEY_MAP.begin(); it != THEME_KEY_MAP.end(); ++it)
+  return c.isLetterOrNumber() || c == '_';
+}
+
+ThemeTemplate::ThemeTemplate(const QString& qss)
+    : mSource(qss)
+{
+  qsizetype literalStart = 0;
+  qsizetype i = 0;
+  while ((i = mSource.indexOf('@', i)) >= 0)
   {
-    const QString& varName = it.key();  // e.g. "@button_bg"
+    // Only whole variables count, @button_bg must not match in @button_bg_hover
+    qsizetype end = i + 1;
+    while (end < mSource.size() && isIdentifierChar(mSource.at(end)))
+      ++end;
+
+    auto it = THEME_KEY_MAP.constFind(mSource.mid(i, end - i));
+    if (it == THEME_KEY_MAP.constEnd())
+    {
+      i = end;
+      continue;
+    }
+
+    if (i > literalStart)
+      mSegments.push_back({literalStart, i - literalStart, nullptr});
 
-    // Create regex to match the whole variable only
-    // (?=[^A-Za-z0-9_]|$) → next char must NOT be a valid identifier char
-    QRegularExpression re(QRegularExpression::escape(varName) + "(?=[^A-Za-z0-9_]|$)");
-    qss.replace(re, t.*(it.value()));
+    mSegments.push_back({i, end - i, it.value()});
+    literalStart = i = end;
   }
 
-  return qss;
+  if (literalStart < mSource.size())
+    mSegments.push_back({literalStart, mSource.size() - literalStart, nullptr});
+}
+
+QString ThemeTemplate::render(const ThemeVars& vars) const
+{
+  QString result;
+  result.reserve(mSource.size());
+
+  for (const Segment& segment : mSegments)
+  {
+    if (segment.variable)
+      result += vars.*(segment.variable);
+    else
+      result += QStringView(mSource).mid(segment.start, segment.length);
+  }
+
+  return result;
 }
 
 void applyThemeToApp(QApplication* app, const QString& theme, const QList<Config::ThemeInfo>& availableThemes)
@@ -60,7 +96,9 @@ void applyThemeToApp(QApplication* app, const QString& theme, const QList<Config
     return;
   }
 
-  auto base = loadFile(":/themes/style.qss");
+  // The stylesheet is part of the resources, it never changes
+  static const ThemeTemplate STYLE_TEMPLATE(loadFile(":/themes/style.qss"));
+
   SYSTEM_THEME = loadThemeVarsFromFile(it->filePath);
   auto foreground = getValueFromTheme("@foreground");
   if (foreground.isValid())
@@ -74,7 +112,7 @@ void applyThemeToApp(QApplication* app, const QString& theme, const QList<Config
   else
     LOG_WARNING("Failed to get highlight color from theme");
 
-  QString styled = applyThemeVars(base, SYSTEM_THEME);
+  QString styled = STYLE_TEMPLATE.render(SYSTEM_THEME);
   // LOG_DEBUG("\n%s", qPrintable(styled));
   app->setStyleSheet(styled);
 }
@@ -201,8 +239,8 @@ QVariant getValueFromTheme(const QString& key)
 
   QString rawValue = SYSTEM_THEME.*(it.value());
 
-  QRegularExpression number("(\\d+)px");
-  QRegularExpressionMatch numberMatch = number.match(rawValue);
+  static const QRegularExpression NUMBER_REGEX("(\\d+)px");
+  QRegularExpressionMatch numberMatch = NUMBER_REGEX.match(rawValue);
 
   if (numberMatch.hasMatch())
     return numberMatch.captured(1).toInt();
@@ -3,6 +3,7 @@
 #include <QColor>
 #include <QHash>
 #include <QString>
+#include <QVector>
 
 #include "app_configs.h"
 
@@ -148,6 +149,27 @@ extern QColor HIGHLIGHT;
 
 QVariant getValueFromTheme(const QString& key);
 
+// A stylesheet split into literal text and theme variables. It is only parsed
+// once, every theme is then rendered in a single pass over the segments.
+class ThemeTemplate
+{
+public:
+  explicit ThemeTemplate(const QString& qss);
+
+  QString render(const ThemeVars& vars) const;
+
+private:
+  struct Segment
+  {
+    qsizetype start;
+    qsizetype length;
+    QString ThemeVars::*variable;  // Null for literal text
+  };
+
+  QString mSource;
+  QVector<Segment> mSegments;
+};
+
 // ------------------------------------------------------------
 // Theme loading stuff
 QString loadFile(const QString& path);
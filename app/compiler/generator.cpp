@@ -9,12 +9,12 @@ Generator::Generator(std::shared_ptr<SaveInfo> storage)
 {
 }
 
-void Generator::generate(GeneratorPlugin* generator)
+QStringList Generator::generate(GeneratorPlugin* generator)
 {
   if (!mStorage)
   {
     LOG_ERROR("No storage available");
-    return;
+    return {};
   }
 
   LOG_INFO("======================================");
@@ -29,4 +29,6 @@ void Generator::generate(GeneratorPlugin* generator)
   // LOG_INFO("Generated code:");
   // LOG_INFO("%s", qPrintable(text));
   LOG_INFO("======================================");
+
+  return generator->writtenFiles();
 }
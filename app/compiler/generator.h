@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QStringList>
+
 #include "result.h"
 #include "system/canvas.h"
 
@@ -10,7 +12,8 @@ class Generator
 public:
   Generator(std::shared_ptr<SaveInfo> storage);
 
-  void generate(GeneratorPlugin* generator);
+  // Returns the files the plugin wrote
+  QStringList generate(GeneratorPlugin* generator);
 
 private:
   const std::shared_ptr<SaveInfo> mStorage;
@@ -4,6 +4,7 @@
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 
 #include "elements/save_info.h"
 
@@ -31,8 +32,11 @@ public:
   virtual QString generateCode(std::shared_ptr<SaveInfo> nodes) = 0;
   virtual generator::Language supportedLanguage() const = 0;
   virtual QString languageName() const = 0;
+  // Absolute paths of the files written by the last generateCode
+  virtual QStringList writtenFiles() const = 0;
 };
 
-#define GeneratorPlugin_iid "com.felipexavier.GeneratorPlugin/1.0"
+// Bumped whenever the interface or the node accessors plugins call change
+#define GeneratorPlugin_iid "com.felipexavier.GeneratorPlugin/1.2"
 
 Q_DECLARE_INTERFACE(GeneratorPlugin, GeneratorPlugin_iid)
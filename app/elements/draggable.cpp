@@ -16,10 +16,7 @@ DraggableItem::DraggableItem(const QString& nodeId, std::shared_ptr<NodeConfig>
     : NodeBase(QUuid::createUuid().toString(), nodeId, nodeConfig, parent)
 {
   if (!config()->body.iconPath.isEmpty())
-  {
-    QPixmap icon(config()->body.iconPath);
-    setPixmap(icon.scaled(scaledRect().size().toSize() * config()->body.iconScale, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-  }
+    setPixmap(iconPixmap(*config()));
   else
     setLabel(config()->type, Fonts::BaseSize);
 }
@@ -60,6 +57,35 @@ void DraggableItem::adjustWidth(int width)
   updateLabelPosition();
 }
 
+QPixmap DraggableItem::iconPixmap(const NodeConfig& config)
+{
+  if (config.body.iconPath.isEmpty())
+    return QPixmap();
+
+  qreal scaleFactor = computeScaleFactor(config);
+  QSize size = QSizeF(config.body.width * scaleFactor, config.body.height * scaleFactor).toSize();
+
+  // Loading by file name goes through QPixmapCache, so the file is only read once
+  QPixmap icon(config.body.iconPath);
+  return icon.scaled(size * config.body.iconScale, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+NodeSaveInfo DraggableItem::dropInfo() const
+{
+  return dropInfo(nodeId(), config());
+}
+
+NodeSaveInfo DraggableItem::dropInfo(const QString& nodeId, const std::shared_ptr<NodeConfig>& config)
+{
+  NodeSaveInfo info;
+  info.nodeId = nodeId;
+  info.type = config->key;
+  info.pixmap = iconPixmap(*config);
+  info.size = QSize(config->body.width, config->body.height);
+
+  return info;
+}
+
 void DraggableItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
 {
   // Draggable pixmap from the scale
@@ -75,14 +101,9 @@ void DraggableItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
   paint(&painter, &opt, nullptr);
   paintLabel(&painter, pixmap.rect());
 
-  NodeSaveInfo info;
-  info.nodeId = nodeId();
-  info.pixmap = nodePixmap();
-  info.size = QSize(config()->body.width, config()->body.height);
-
   QByteArray data;
   QDataStream stream(&data, QIODevice::WriteOnly);
-  stream << info;
+  stream << dropInfo();
 
   QMimeData* mimeData = new QMimeData();
   mimeData->setData(Constants::TYPE_NODE, data);
@@ -12,6 +12,7 @@
 
 #include "config.h"
 #include "node_base.h"
+#include "save_info.h"
 #include "types.h"
 
 class DraggableItem : public NodeBase
@@ -28,6 +29,11 @@ public:
   int type() const override;
   void adjustWidth(int width);
 
+  // What gets dropped on the canvas
+  NodeSaveInfo dropInfo() const;
+  // Same without creating the item, e.g. for nodes added from the palette
+  static NodeSaveInfo dropInfo(const QString& nodeId, const std::shared_ptr<NodeConfig>& config);
+
   QPainterPath shape() const override;
   void paint(QPainter* painter, const QStyleOptionGraphicsItem* style, QWidget* widget) override;
 
@@ -38,5 +44,8 @@ protected:
 
 private:
   std::shared_ptr<QPixmap> mPixmap;
+
+  // Icon scaled to the library size, null if the config has none
+  static QPixmap iconPixmap(const NodeConfig& config);
   std::shared_ptr<QGraphicsTextItem> mLabel;
 };
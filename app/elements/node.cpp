@@ -42,30 +42,35 @@ NodeItem::NodeItem(const QString& nodeId, std::shared_ptr<NodeSaveInfo> info, co
     setZValue(parent->zValue() + 2);
   }
 
-  LOG_INFO("Created node with zvalue: %f", zValue());
-
-  for (const auto& property : config()->properties)
+  // New nodes share the prebuilt defaults until they are modified
+  if (mStorage->properties.isEmpty())
   {
-    if (!mStorage->properties.contains(property.id))
-      mStorage->properties[property.id] = property.defaultValue;
+    mStorage->properties = config()->defaultProperties;
   }
-
-  for (const auto& event : config()->events)
+  else
   {
-    bool found = false;
-    for (const auto& flow : mStorage->flows)
+    for (auto property = config()->defaultProperties.cbegin(); property != config()->defaultProperties.cend(); ++property)
     {
-      if (flow->name != event.name)
-        continue;
-
-      found = true;
-      break;
+      if (!mStorage->properties.contains(property.key()))
+        mStorage->properties.insert(property.key(), property.value());
     }
+  }
 
-    if (found)
-      continue;
+  // Flows get their own id, so only the missing events are created
+  QSet<QString> existingEvents;
+  for (const auto& flow : mStorage->flows)
+  {
+    if (config()->eventNames.contains(flow->name))
+      existingEvents.insert(flow->name);
+  }
 
-    mStorage->flows.push_back(std::make_shared<FlowSaveInfo>(event));
+  if (existingEvents.size() < config()->eventNames.size())
+  {
+    for (const auto& event : config()->events)
+    {
+      if (!existingEvents.contains(event.name))
+        mStorage->flows.push_back(std::make_shared<FlowSaveInfo>(event));
+    }
   }
 
   // Add icon if it exists
@@ -83,11 +88,15 @@ NodeItem::NodeItem(const QString& nodeId, std::shared_ptr<NodeSaveInfo> info, co
   updatePosition(snapToGrid(initialPosition - boundingRect().center(), Config::GRID_SIZE));
   // updatePosition(initialPosition);
 
-  LOG_DEBUG("%s created at: (%f, %f) with size (%f, %f) and scale %f", qPrintable(id()), pos().x(), pos().y(), mSize.width(), mSize.height(), baseScale());
+  LOG_DEBUG("%s created at: (%f, %f) with size (%f, %f), scale %f and zvalue %f", qPrintable(id()), pos().x(), pos().y(), mSize.width(), mSize.height(), baseScale(), zValue());
 }
 
 NodeItem::~NodeItem()
 {
+  auto canvas = dynamic_cast<Canvas*>(scene());
+  if (canvas)
+    canvas->unindexItem(this);
+
   // auto copy = transitions();
   // for (auto& item : copy)
   //   delete item;
@@ -120,6 +129,21 @@ qreal NodeItem::baseScale() const
   return mStorage->scale;
 }
 
+void NodeItem::resize(const QSizeF& size, qreal scale)
+{
+  prepareGeometryChange();
+
+  mStorage->scale = scale;
+  mSize = size;
+  mStorage->size = mSize;
+
+  qreal newFontSize = qMax(Fonts::BaseSize, mSize.width() / Fonts::BaseFactor);
+  setLabelSize(newFontSize, mSize);
+
+  updateIndex();
+  update();
+}
+
 VoidResult NodeItem::start()
 {
   return NodeBase::start();
@@ -146,27 +170,27 @@ QPainterPath NodeItem::shape() const
   return NodeBase::nodeShape(boundingRect());
 }
 
-QVector<PropertiesConfig> NodeItem::configurationProperties() const
+const QVector<PropertiesConfig>& NodeItem::configurationProperties() const
 {
   return config()->properties;
 }
 
-QMap<QString, QVariant> NodeItem::properties() const
+const QMap<QString, QVariant>& NodeItem::properties() const
 {
   return mStorage->properties;
 }
 
-QVector<PropertiesConfig> NodeItem::fields() const
+const QVector<PropertiesConfig>& NodeItem::fields() const
 {
   return mStorage->fields;
 }
 
-QVector<std::shared_ptr<FlowSaveInfo>> NodeItem::events() const
+const QVector<std::shared_ptr<FlowSaveInfo>>& NodeItem::events() const
 {
   return mStorage->flows;
 }
 
-QVector<ControlsConfig> NodeItem::controls() const
+const QVector<ControlsConfig>& NodeItem::controls() const
 {
   return config()->controls;
 }
@@ -184,7 +208,7 @@ QVariant NodeItem::getProperty(const QString& key) const
 
 void NodeItem::setProperty(const QString& key, QVariant value)
 {
-  LOG_INFO("[%s] Setting property of node: %s", qPrintable(id()), qPrintable(nodeId()));
+  LOG_DEBUG("[%s] Setting property of node: %s", qPrintable(id()), qPrintable(nodeId()));
   if (!mStorage)
     return;
 
@@ -194,10 +218,17 @@ void NodeItem::setProperty(const QString& key, QVariant value)
     return;
   }
 
+  auto canvas = dynamic_cast<Canvas*>(scene());
+  if (canvas)
+    canvas->recordPropertyChange(this, key, mStorage->properties.value(key), value);
+
   mStorage->properties[key] = value;
 
   if (key == "name")
+  {
     setLabelName(value.toString());
+    updateIndex();
+  }
 
   if (nodeModified)
     nodeModified(this);
@@ -210,23 +241,11 @@ VoidResult NodeItem::setField(const QString& key, const QJsonObject& value)
   if (!mStorage)
     return VoidResult::Failed("Storage is not set");
 
-  // Check if key exists
   auto property = PropertiesConfig(value);
   if (!property.isValid())
     return VoidResult::Failed(property.errorMessage.toStdString());
 
-  for (auto& field : fields())
-  {
-    if (field.id != key)
-      continue;
-
-    field = property;
-    return VoidResult();
-  }
-
-  mStorage->fields.push_back(property);
-
-  return VoidResult();
+  return setField(key, property);
 }
 
 VoidResult NodeItem::setField(const QString& key, const PropertiesConfig& property)
@@ -234,18 +253,32 @@ VoidResult NodeItem::setField(const QString& key, const PropertiesConfig& proper
   if (!mStorage)
     return VoidResult::Failed("Storage is not set");
 
+  auto canvas = dynamic_cast<Canvas*>(scene());
+
   // Check if key exists
   for (auto& field : mStorage->fields)
   {
     if (field.id != key)
       continue;
 
+    if (canvas)
+      canvas->recordFieldChange(this, key, field, property);
+
     field = property;
+    if (nodeModified)
+      nodeModified(this);
+
     return VoidResult();
   }
 
+  if (canvas)
+    canvas->recordFieldChange(this, key, std::nullopt, property);
+
   mStorage->fields.push_back(property);
 
+  if (nodeModified)
+    nodeModified(this);
+
   return VoidResult();
 }
 
@@ -273,7 +306,15 @@ void NodeItem::removeField(const QString& key)
     if (iter->id != key)
       continue;
 
+    auto canvas = dynamic_cast<Canvas*>(scene());
+    if (canvas)
+      canvas->recordFieldChange(this, key, *iter, std::nullopt);
+
     mStorage->fields.erase(iter);
+
+    if (nodeModified)
+      nodeModified(this);
+
     return;
   }
 }
@@ -289,7 +330,7 @@ void NodeItem::setEvent(int index, const FlowConfig& event)
   //   mStorage->events.push_back(event);
 }
 
-QVector<INode*> NodeItem::children() const
+const QVector<INode*>& NodeItem::children() const
 {
   return mChildrenNodes;
 }
@@ -349,17 +390,7 @@ void NodeItem::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
     }
 
     // Update the scale when the node is resized
-    mStorage->scale = qMax(config()->body.width / newWidth, config()->body.height / newHeight);
-
-    mSize.setWidth(newWidth);
-    mSize.setHeight(newHeight);
-    mStorage->size = mSize;
-
-    qreal newFontSize = qMax(Fonts::BaseSize, mSize.width() / Fonts::BaseFactor);
-
-    setLabelSize(newFontSize, mSize);
-    prepareGeometryChange();
-    update();
+    resize(QSizeF(newWidth, newHeight), qMax(config()->body.width / newWidth, config()->body.height / newHeight));
   }
   else
   {
@@ -374,6 +405,7 @@ void NodeItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
     mIsResizing = true;
     mResizeStartMousePos = event->pos();
     mResizeStartSize = mSize;
+    mResizeStartScale = mStorage->scale;
     dynamic_cast<QGraphicsView*>(scene()->parent())->setCursor(Qt::SizeFDiagCursor);
     event->accept();
   }
@@ -389,6 +421,10 @@ void NodeItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
   {
     mIsResizing = false;
     dynamic_cast<QGraphicsView*>(scene()->parent())->setCursor(Qt::ArrowCursor);
+
+    auto canvas = dynamic_cast<Canvas*>(scene());
+    if (canvas)
+      canvas->recordResize(this, mResizeStartSize, mResizeStartScale);
   }
 
   QGraphicsItem::mouseReleaseEvent(event);
@@ -420,6 +456,24 @@ QVariant NodeItem::itemChange(GraphicsItemChange change, const QVariant& value)
     updateExtrasPosition();
     mStorage->position = pos() + boundingRect().center();
   }
+  else if (change == QGraphicsItem::ItemScenePositionHasChanged)
+  {
+    // Also sent to the children when the parent moves
+    updateIndex();
+
+    if (parentNode())
+      updateExtrasPosition();
+  }
+  else if (change == QGraphicsItem::ItemSceneChange)
+  {
+    auto canvas = dynamic_cast<Canvas*>(scene());
+    if (canvas)
+      canvas->unindexItem(this);
+  }
+  else if (change == QGraphicsItem::ItemSceneHasChanged)
+  {
+    updateIndex();
+  }
 
   return QGraphicsItem::itemChange(change, value);
 }
@@ -433,12 +487,27 @@ void NodeItem::updatePosition(const QPointF& position)
 
 void NodeItem::updateExtrasPosition()
 {
+  // Let the canvas rebuild the transitions once per frame, they are shared with
+  // other nodes that may be moving as well
+  auto canvas = dynamic_cast<Canvas*>(scene());
   for (auto& transition : transitions())
-    transition->updatePath();
+  {
+    if (canvas)
+      canvas->scheduleTransitionUpdate(transition);
+    else
+      transition->updatePath();
+  }
 
   updateLabelPosition();
 }
 
+void NodeItem::updateIndex()
+{
+  auto canvas = dynamic_cast<Canvas*>(scene());
+  if (canvas)
+    canvas->indexItem(this);
+}
+
 // Slots
 void NodeItem::deleteNode()
 {
@@ -468,12 +537,17 @@ void NodeItem::onProperties()
   // Handle the properties action, e.g., show a dialog to edit properties
 }
 
-NodeSaveInfo NodeItem::saveInfo() const
+const NodeSaveInfo& NodeItem::saveInfo() const
 {
   return *mStorage;
 }
 
-QVector<TransitionItem*> NodeItem::transitions() const
+std::shared_ptr<NodeSaveInfo> NodeItem::storage() const
+{
+  return mStorage;
+}
+
+const QVector<TransitionItem*>& NodeItem::transitions() const
 {
   return mTransitions;
 }
@@ -552,28 +626,27 @@ QPointF NodeItem::edgePointToward(const QPointF& targetScenePos) const
   return center + dir * radius;
 }
 
-bool NodeItem::canAddTransition() const
+int NodeItem::outgoingTransitions() const
 {
-  int index = 0;
-  for (const auto& t : transitions())
+  int count = 0;
+  for (const auto& t : mTransitions)
   {
-    if (t->source()->id() == id())
-      ++index;
+    if (t->source() == this)
+      ++count;
   }
 
-  return config()->transitions.isEmpty() || index < config()->transitions.size();
+  return count;
+}
+
+bool NodeItem::canAddTransition() const
+{
+  return config()->transitions.isEmpty() || outgoingTransitions() < config()->transitions.size();
 }
 
 TransitionConfig NodeItem::nextTransition() const
 {
   // Only count the transitions coming from this
-  int index = 0;
-  for (const auto& t : transitions())
-  {
-    if (t->source()->id() == id())
-      ++index;
-  }
-
+  int index = outgoingTransitions();
   if (config()->transitions.isEmpty() || index >= config()->transitions.size())
     return TransitionConfig();
 
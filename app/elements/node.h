@@ -40,10 +40,10 @@ public:
   QString nodeName() const override;
   QString nodeType() const override;
   QString behaviour() const;
-  QVector<ControlsConfig> controls() const;
-  QVector<PropertiesConfig> fields() const override;
-  QMap<QString, QVariant> properties() const override;
-  QVector<PropertiesConfig> configurationProperties() const;
+  const QVector<ControlsConfig>& controls() const;
+  const QVector<PropertiesConfig>& fields() const override;
+  const QMap<QString, QVariant>& properties() const override;
+  const QVector<PropertiesConfig>& configurationProperties() const;
 
   Types::LibraryTypes function() const override;
 
@@ -58,15 +58,15 @@ public:
   void renameNode(const QString& name);
 
   INode* parentNode() const override;
-  QVector<INode*> children() const override;
+  const QVector<INode*>& children() const override;
 
-  QVector<TransitionItem*> transitions() const;
+  const QVector<TransitionItem*>& transitions() const;
   void addTransition(TransitionItem* transition);
   void removeTransition(TransitionItem* transition);
   QPointF edgePointToward(const QPointF& targetScenePos) const;
 
   void setEvent(int index, const FlowConfig& event);
-  QVector<std::shared_ptr<FlowSaveInfo>> events() const;
+  const QVector<std::shared_ptr<FlowSaveInfo>>& events() const;
 
   void addChild(NodeItem* node, std::shared_ptr<NodeSaveInfo> info);
   void childRemoved(NodeItem* child);
@@ -78,6 +78,7 @@ public:
   void updateFlow();
 
   qreal baseScale() const;
+  void resize(const QSizeF& size, qreal scale);
 
   bool canAddTransition() const;
   TransitionConfig nextTransition() const;
@@ -92,7 +93,9 @@ public:
   void onProperties();
 
   // Serialization functions
-  NodeSaveInfo saveInfo() const;
+  const NodeSaveInfo& saveInfo() const;
+  // The live storage, for callers that only serialize it
+  std::shared_ptr<NodeSaveInfo> storage() const;
 
   friend QDataStream& operator<<(QDataStream& out, const NodeItem& config);
   friend QDataStream& operator>>(QDataStream& in, NodeItem& config);
@@ -118,7 +121,10 @@ private:
   bool mIsResizing{false};
   QPointF mResizeStartMousePos{0, 0};
   QSizeF mResizeStartSize{0, 0};
+  qreal mResizeStartScale{1.0};
 
+  int outgoingTransitions() const;
   void updatePosition(const QPointF& position);
   void updateExtrasPosition();
+  void updateIndex();
 };
@@ -22,7 +22,7 @@ NodeBase::NodeBase(const QString& id, const QString& nodeId, std::shared_ptr<Nod
 {
   setZValue(config()->body.zIndex);
 
-  qreal scaleFactor = computeScaleFactor();
+  qreal scaleFactor = computeScaleFactor(*config());
   mScaledBounds = QRectF(0, 0, config()->body.width * scaleFactor, config()->body.height * scaleFactor);
 }
 
@@ -46,7 +46,7 @@ VoidResult NodeBase::start()
   return VoidResult();
 }
 
-std::shared_ptr<NodeConfig> NodeBase::config() const
+const std::shared_ptr<NodeConfig>& NodeBase::config() const
 {
   return mConfig;
 }
@@ -214,14 +214,14 @@ void NodeBase::setPixmap(const QPixmap& pixmap)
   mPixmapItem = std::make_shared<QGraphicsPixmapItem>(pixmap);
 }
 
-qreal NodeBase::computeScaleFactor() const
+qreal NodeBase::computeScaleFactor(const NodeConfig& config)
 {
-  qreal widthScale = (config()->body.width > MAX_WIDTH)
-                         ? MAX_WIDTH / config()->body.width
+  qreal widthScale = (config.body.width > MAX_WIDTH)
+                         ? MAX_WIDTH / config.body.width
                          : 1.0;
 
-  qreal heightScale = (config()->body.height > MAX_HEIGHT)
-                          ? MAX_HEIGHT / config()->body.height
+  qreal heightScale = (config.body.height > MAX_HEIGHT)
+                          ? MAX_HEIGHT / config.body.height
                           : 1.0;
 
   return qMin(widthScale, heightScale);  // Use the smallest scale to maintain aspect ratio
@@ -23,7 +23,7 @@ public:
   virtual QString nodeId() const;
 
   virtual VoidResult start();
-  virtual std::shared_ptr<NodeConfig> config() const;
+  virtual const std::shared_ptr<NodeConfig>& config() const;
 
   virtual QRectF boundingRect() const override;
   virtual QRectF scaledRect() const;
@@ -47,6 +47,9 @@ protected:
   virtual void setLabelName(const QString& name);
   virtual void setLabelSize(qreal fontSize, const QSizeF& boundingSize);
 
+  // Scale that fits the node body in the library, the same for every node of a config
+  static qreal computeScaleFactor(const NodeConfig& config);
+
   virtual void paintLabel(QPainter* painter, const QRectF& area) const;
   virtual void paintPixmap(QPainter* painter) const;
 
@@ -56,6 +59,4 @@ private:
   const QString mNodeId;
 
   QRectF mScaledBounds;
-
-  qreal computeScaleFactor() const;
 };
@@ -7,12 +7,23 @@
 #include "json.h"
 #include "keys.h"
 #include "logging.h"
+#include "symbol.h"
 
 Q_DECLARE_METATYPE(TransitionSaveInfo)
 Q_DECLARE_METATYPE(FlowSaveInfo)
 Q_DECLARE_METATYPE(NodeSaveInfo)
 Q_DECLARE_METATYPE(SaveInfo)
 
+// Property keys repeat on every node, so the loaded ones share the interned strings
+static QMap<QString, QVariant> canonicalKeys(const QMap<QString, QVariant>& properties)
+{
+  QMap<QString, QVariant> result;
+  for (auto it = properties.cbegin(); it != properties.cend(); ++it)
+    result.insert(Symbol::canonical(it.key()), it.value());
+
+  return result;
+}
+
 // ==========================================================================================================
 // FlowSaveInfo
 QDataStream& operator<<(QDataStream& out, const QVector<std::shared_ptr<FlowSaveInfo>>& flows)
@@ -29,9 +40,14 @@ QDataStream& operator>>(QDataStream& in, QVector<std::shared_ptr<FlowSaveInfo>>&
   qint32 size;
   in >> size;
 
-  flows.resize(size);
+  flows.clear();
+  flows.reserve(size);
   for (int i = 0; i < size; ++i)
-    in >> *flows[i];
+  {
+    auto item = std::make_shared<FlowSaveInfo>();
+    in >> *item;
+    flows.push_back(item);
+  }
 
   return in;
 }
@@ -135,9 +151,14 @@ QDataStream& operator>>(QDataStream& in, QVector<std::shared_ptr<TransitionSaveI
   qint32 size;
   in >> size;
 
-  transitions.resize(size);
+  transitions.clear();
+  transitions.reserve(size);
   for (int i = 0; i < size; ++i)
-    in >> *transitions[i];
+  {
+    auto item = std::make_shared<TransitionSaveInfo>();
+    in >> *item;
+    transitions.push_back(item);
+  }
 
   return in;
 }
@@ -232,9 +253,14 @@ QDataStream& operator>>(QDataStream& in, QVector<std::shared_ptr<NodeSaveInfo>>&
   qint32 size;
   in >> size;
 
-  nodes.resize(size);
+  nodes.clear();
+  nodes.reserve(size);
   for (int i = 0; i < size; ++i)
-    in >> *nodes[i];
+  {
+    auto item = std::make_shared<NodeSaveInfo>();
+    in >> *item;
+    nodes.push_back(item);
+  }
 
   return in;
 }
@@ -252,6 +278,9 @@ QDataStream& operator<<(QDataStream& out, const NodeSaveInfo& info)
   out << info.transitions;
   out << info.children;
   out << info.flows;
+
+  // The behaviour is only there once it has been edited
+  out << (info.behaviour != nullptr);
   if (info.behaviour)
     out << *info.behaviour;
 
@@ -271,16 +300,26 @@ QDataStream& operator>>(QDataStream& in, NodeSaveInfo& info)
   in >> info.size;
   in >> info.scale;
   in >> info.nodeId;
+  info.type = Symbol(info.nodeId);
+  info.nodeId = info.type.toString();
   in >> info.fields;
   in >> info.position;
   in >> info.properties;
+  info.properties = canonicalKeys(info.properties);
   in >> info.parentId;
   in >> info.transitions;
   in >> info.children;
   in >> info.flows;
 
-  info.behaviour = std::make_shared<FlowSaveInfo>();
-  in >> *info.behaviour;
+  bool hasBehaviour = false;
+  in >> hasBehaviour;
+
+  info.behaviour = nullptr;
+  if (hasBehaviour)
+  {
+    info.behaviour = std::make_shared<FlowSaveInfo>();
+    in >> *info.behaviour;
+  }
 
   QByteArray pixmapData;
   in >> pixmapData;
@@ -301,7 +340,8 @@ QJsonObject NodeSaveInfo::toJson() const
   data[ConfigKeys::SIZE] = JSON::fromSizeF(size);
   data[ConfigKeys::POSITION] = JSON::fromPointF(position);
 
-  data[ConfigKeys::BEHAVIOUR] = behaviour->toJson();
+  if (behaviour)
+    data[ConfigKeys::BEHAVIOUR] = behaviour->toJson();
 
   QJsonArray fieldArray;
   for (const auto& field : fields)
@@ -345,7 +385,8 @@ NodeSaveInfo NodeSaveInfo::fromJson(const QJsonObject& data)
 
   // First parse the mandatory arguments
   info.id = data[ConfigKeys::ID].toString();
-  info.nodeId = data[ConfigKeys::NODE_ID].toString();
+  info.type = Symbol(data[ConfigKeys::NODE_ID].toString());
+  info.nodeId = info.type.toString();
 
   info.scale = data[ConfigKeys::SCALE].toDouble();
   info.size = JSON::toSizeF(data[ConfigKeys::SIZE].toObject());
@@ -384,7 +425,7 @@ NodeSaveInfo NodeSaveInfo::fromJson(const QJsonObject& data)
   {
     const auto propertiesObject = data[ConfigKeys::PROPERTIES].toObject();
     for (const QString& key : propertiesObject.keys())
-      info.properties[key] = propertiesObject.value(key);
+      info.properties[Symbol::canonical(key)] = propertiesObject.value(key);
   }
 
   info.pixmap = JSON::toPixmap(data[ConfigKeys::PIXMAP].toObject());
@@ -486,7 +527,7 @@ SaveInfo SaveInfo::fromJson(const QJsonObject& data)
   return info;
 }
 
-QVector<std::shared_ptr<NodeSaveInfo>> SaveInfo::findFamilyOfConstruct(const QString& nodeId, QVector<std::shared_ptr<NodeSaveInfo>> nodes) const
+QVector<std::shared_ptr<NodeSaveInfo>> SaveInfo::findFamilyOfConstruct(const QString& nodeId, const QVector<std::shared_ptr<NodeSaveInfo>>& nodes) const
 {
   for (const auto& node : nodes)
   {
@@ -502,7 +543,7 @@ QVector<std::shared_ptr<NodeSaveInfo>> SaveInfo::findFamilyOfConstruct(const QSt
   return {};
 }
 
-std::shared_ptr<NodeSaveInfo> SaveInfo::findParentOfConstruct(const QString& nodeId, const std::shared_ptr<NodeSaveInfo> node) const
+std::shared_ptr<NodeSaveInfo> SaveInfo::findParentOfConstruct(const QString& nodeId, const std::shared_ptr<NodeSaveInfo>& node) const
 {
   if (node->behaviour != nullptr)
   {
@@ -529,7 +570,7 @@ std::shared_ptr<NodeSaveInfo> SaveInfo::findParentOfConstruct(const QString& nod
   return nullptr;
 }
 
-void SaveInfo::findStatesOfConstruct(QVector<std::shared_ptr<NodeSaveInfo>>& toReturn, QVector<std::shared_ptr<NodeSaveInfo>> nodes) const
+void SaveInfo::findStatesOfConstruct(QVector<std::shared_ptr<NodeSaveInfo>>& toReturn, const QVector<std::shared_ptr<NodeSaveInfo>>& nodes) const
 {
   for (const auto& node : nodes)
   {
@@ -553,7 +594,7 @@ QVector<std::shared_ptr<NodeSaveInfo>> SaveInfo::getPossibleCallers(const QStrin
   return findFamilyOfConstruct(nodeId, structuralNodes);
 }
 
-QVector<std::shared_ptr<FlowSaveInfo>> SaveInfo::getEventsFromNode(const QString& nodeId, QVector<std::shared_ptr<NodeSaveInfo>> nodes) const
+QVector<std::shared_ptr<FlowSaveInfo>> SaveInfo::getEventsFromNode(const QString& nodeId, const QVector<std::shared_ptr<NodeSaveInfo>>& nodes) const
 {
   for (const auto& node : nodes)
   {
@@ -11,6 +11,11 @@
 
 struct NodeSaveInfo;
 
+// Node infos that leave the process, like the ones copied to the clipboard, start
+// with these. Bump the version whenever the node stream layout changes.
+static const quint32 SAVE_MAGIC = 0x4d414b49;  // "MAKI"
+static const quint32 SAVE_FORMAT_VERSION = 1;
+
 struct FlowSaveInfo
 {
   QString id = "";
@@ -61,6 +66,8 @@ struct NodeSaveInfo
 {
   QString id = "";
   QString nodeId = "";
+  // Handle of nodeId, resolved once when the info is created or loaded
+  Symbol type;
   QPointF position{0, 0};
   QPixmap pixmap;
   QSizeF size{0, 0};
@@ -115,11 +122,11 @@ struct SaveInfo
   std::shared_ptr<FlowSaveInfo> getFlowWithId(const QString& flowId);
 
 private:
-  QVector<std::shared_ptr<NodeSaveInfo>> findFamilyOfConstruct(const QString& nodeId, QVector<std::shared_ptr<NodeSaveInfo>> nodes) const;
-  std::shared_ptr<NodeSaveInfo> findParentOfConstruct(const QString& nodeId, const std::shared_ptr<NodeSaveInfo> node) const;
-  void findStatesOfConstruct(QVector<std::shared_ptr<NodeSaveInfo>>& toReturn, QVector<std::shared_ptr<NodeSaveInfo>> nodes) const;
+  QVector<std::shared_ptr<NodeSaveInfo>> findFamilyOfConstruct(const QString& nodeId, const QVector<std::shared_ptr<NodeSaveInfo>>& nodes) const;
+  std::shared_ptr<NodeSaveInfo> findParentOfConstruct(const QString& nodeId, const std::shared_ptr<NodeSaveInfo>& node) const;
+  void findStatesOfConstruct(QVector<std::shared_ptr<NodeSaveInfo>>& toReturn, const QVector<std::shared_ptr<NodeSaveInfo>>& nodes) const;
 
-  QVector<std::shared_ptr<FlowSaveInfo>> getEventsFromNode(const QString& nodeId, QVector<std::shared_ptr<NodeSaveInfo>> nodes) const;
+  QVector<std::shared_ptr<FlowSaveInfo>> getEventsFromNode(const QString& nodeId, const QVector<std::shared_ptr<NodeSaveInfo>>& nodes) const;
   std::shared_ptr<NodeSaveInfo> getNodeWithId(const QString& nodeId, const QVector<std::shared_ptr<NodeSaveInfo>>& nodes);
   std::shared_ptr<FlowSaveInfo> getFlowWithId(const QString& flowId, const QVector<std::shared_ptr<NodeSaveInfo>>& nodes);
 };
@@ -6,6 +6,7 @@
 
 #include "app_configs.h"
 #include "node.h"
+#include "system/canvas.h"
 #include "theme.h"
 
 TransitionItem::TransitionItem(std::shared_ptr<TransitionSaveInfo> storage)
@@ -35,6 +36,10 @@ TransitionItem::TransitionItem(std::shared_ptr<TransitionSaveInfo> storage)
 
 TransitionItem::~TransitionItem()
 {
+  auto canvas = dynamic_cast<Canvas*>(scene());
+  if (canvas)
+    canvas->unindexItem(this);
+
   if (mSource != nullptr)
     mSource->removeTransition(this);
   if (mDestination != nullptr)
@@ -79,6 +84,12 @@ void TransitionItem::done(NodeItem* source, NodeItem* destination)
   move(mStorage->dstId, mStorage->dstPoint);
 }
 
+void TransitionItem::detach()
+{
+  mSource = nullptr;
+  mDestination = nullptr;
+}
+
 void TransitionItem::setEdge(Edge edge)
 {
   mEdge = edge;
@@ -111,6 +122,7 @@ void TransitionItem::move(const QString& id, QPointF pos)
   setPath(path);
   updateLabelPosition();
   prepareGeometryChange();
+  updateIndex();
 }
 
 void TransitionItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
@@ -148,6 +160,29 @@ QPainterPath TransitionItem::shape() const
   return stroker.createStroke(path());
 }
 
+QVariant TransitionItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+  if (change == QGraphicsItem::ItemSceneChange)
+  {
+    auto canvas = dynamic_cast<Canvas*>(scene());
+    if (canvas)
+      canvas->unindexItem(this);
+  }
+  else if (change == QGraphicsItem::ItemSceneHasChanged)
+  {
+    updateIndex();
+  }
+
+  return QGraphicsPathItem::itemChange(change, value);
+}
+
+void TransitionItem::updateIndex()
+{
+  auto canvas = dynamic_cast<Canvas*>(scene());
+  if (canvas)
+    canvas->indexItem(this);
+}
+
 std::shared_ptr<TransitionSaveInfo> TransitionItem::storage() const
 {
   return mStorage;
@@ -192,6 +227,7 @@ void TransitionItem::updatePath()
   setPath(path);
   updateLabelPosition();
   prepareGeometryChange();
+  updateIndex();
 }
 
 QString TransitionItem::getName() const
@@ -34,6 +34,8 @@ public:
   void setStart(const QString& id, const QPointF& point, const QPointF& controlShift);
   void setEnd(const QString& id, const QPointF& point, const QPointF& controlShift);
   void done(NodeItem* source, NodeItem* destination);
+  // Forget the nodes without touching their storage
+  void detach();
 
   NodeItem* source() const;
   NodeItem* destination() const;
@@ -43,6 +45,7 @@ public:
 
   void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
   QPainterPath shape() const override;
+  QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
 
   TransitionSaveInfo saveInfo() const;
   std::shared_ptr<TransitionSaveInfo> storage() const;
@@ -72,4 +75,5 @@ private:
   std::shared_ptr<TransitionSaveInfo> mStorage;
 
   void updateLabelPosition();
+  void updateIndex();
 };
@@ -17,6 +17,7 @@ QString DezyneGenerator::generateCode(std::shared_ptr<SaveInfo> storage)
 {
   LOG_DEBUG("Starting generation");
   mStorage = storage;
+  mWrittenFiles.clear();
 
   mOutputFolder = QDir(QDir::currentPath() + FOLDER);
   if (!mOutputFolder.exists())
@@ -45,6 +46,11 @@ QString DezyneGenerator::languageName() const
   return "Dezyne";
 }
 
+QStringList DezyneGenerator::writtenFiles() const
+{
+  return mWrittenFiles;
+}
+
 // Add function per block type
 QString DezyneGenerator::generateNode(const NodeSaveInfo& node)
 {
@@ -117,6 +123,7 @@ QString DezyneGenerator::generateTimer(const NodeSaveInfo& node)
   {
     QFileInfo fileInfo(file.fileName());
     mImports.push_back(fileInfo.fileName());
+    mWrittenFiles.push_back(fileInfo.absoluteFilePath());
     QTextStream out(&file);
     out << "interface i" + name << "\n";
     out << "{\n";
@@ -160,6 +167,7 @@ QString DezyneGenerator::generateAuthenticator(const NodeSaveInfo& node)
   {
     QFileInfo fileInfo(file.fileName());
     mImports.push_back(fileInfo.fileName());
+    mWrittenFiles.push_back(fileInfo.absoluteFilePath());
     QTextStream out(&file);
     out << "interface i" + name << "\n";
     out << "{\n";
@@ -199,6 +207,7 @@ QString DezyneGenerator::generateSiren(const NodeSaveInfo& node)
   {
     QFileInfo fileInfo(file.fileName());
     mImports.push_back(fileInfo.fileName());
+    mWrittenFiles.push_back(fileInfo.absoluteFilePath());
     QTextStream out(&file);
     out << "interface i" + name << "\n";
     out << "{\n";
@@ -240,6 +249,7 @@ QString DezyneGenerator::generatePresenceSensor(const NodeSaveInfo& node)
   {
     QFileInfo fileInfo(file.fileName());
     mImports.push_back(fileInfo.fileName());
+    mWrittenFiles.push_back(fileInfo.absoluteFilePath());
     QTextStream out(&file);
     out << "interface i" + name << "\n";
     out << "{\n";
@@ -284,6 +294,7 @@ QString DezyneGenerator::generateComponent(const NodeSaveInfo& node)
     LOG_WARNING("Failed to open device for writing");
     return code;
   }
+  mWrittenFiles.push_back(QFileInfo(file).absoluteFilePath());
   
   // Generate child code
   for (const auto& child : node.children)
@@ -370,6 +381,7 @@ QString DezyneGenerator::generateInterface(const NodeSaveInfo& node)
     LOG_WARNING("Failed to open device for writing");
     return code;
   }
+  mWrittenFiles.push_back(QFileInfo(file).absoluteFilePath());
   
   // Generate child code
   for (const auto& child : node.children)
@@ -15,11 +15,13 @@ public:
   QString generateCode(std::shared_ptr<SaveInfo> nodes) override;
   generator::Language supportedLanguage() const override;
   QString languageName() const override;
+  QStringList writtenFiles() const override;
 
 private:
   QDir mOutputFolder;
   std::shared_ptr<SaveInfo> mStorage;
   QVector<QString> mImports;
+  QStringList mWrittenFiles;
   
   struct Argument
   {
@@ -2,6 +2,7 @@
 
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QTextStream>
@@ -18,6 +19,7 @@ QString RozyneGenerator::generateCode(std::shared_ptr<SaveInfo> storage)
 {
   LOG_DEBUG("Starting generation");
   mStorage = storage;
+  mWrittenFiles.clear();
 
   mOutputFolder = QDir(QDir::currentPath() + FOLDER);
   if (!mOutputFolder.exists())
@@ -68,6 +70,11 @@ QString RozyneGenerator::languageName() const
   return "Rozyne";
 }
 
+QStringList RozyneGenerator::writtenFiles() const
+{
+  return mWrittenFiles;
+}
+
 // Add function per block type
 QString RozyneGenerator::generateNode(const NodeSaveInfo& node)
 {
@@ -85,28 +92,25 @@ QString RozyneGenerator::generateNode(const NodeSaveInfo& node)
 
 QString RozyneGenerator::generateBehaviourNode(const NodeSaveInfo& node, const Argument& arg, const FlowSaveInfo& flow, const QString& format)
 {
-  QString code = "";
-  QString type = node.nodeId;
-  QString name = node.properties["name"].toString();
-
-  // LOG_DEBUG("Generating code for %s with %s", qPrintable(type), qPrintable(arg.name));
-
-  if (type == "Mission::End")
-    code += generateEnd(node, arg, flow, format);
-  else if (type == "Mission::Error")
-    code += generateError(node, arg, flow, format);
-  else if (type == "Mission::Async task")
-    code += generateAsyncTask(node, arg, flow, format);
-  else if (type == "Mission::Sync task")
-    code += generateSyncTask(node, arg, flow, format);
-  else if (type == "Mission::Strategy")
-    code += generateStrategy(node, arg, flow, format);
-  else if (type == "Mission::Within")
-    code += generateWithin(node, arg, flow, format);
-  else if (type == "Mission::Repeat")
-    code += generateRepeat(node, arg, flow, format);
-
-  return code;
+  // One lookup per node instead of comparing the type against every block.
+  // Symbol handles are not shared with plugins, so the table is keyed by the type string.
+  static const QHash<QString, BehaviourGenerator> generators = {
+      {"Mission::End", &RozyneGenerator::generateEnd},
+      {"Mission::Error", &RozyneGenerator::generateError},
+      {"Mission::Async task", &RozyneGenerator::generateAsyncTask},
+      {"Mission::Sync task", &RozyneGenerator::generateSyncTask},
+      {"Mission::Strategy", &RozyneGenerator::generateStrategy},
+      {"Mission::Within", &RozyneGenerator::generateWithin},
+      {"Mission::Repeat", &RozyneGenerator::generateRepeat},
+  };
+
+  // LOG_DEBUG("Generating code for %s with %s", qPrintable(node.nodeId), qPrintable(arg.name));
+
+  auto generator = generators.value(node.nodeId, nullptr);
+  if (generator == nullptr)
+    return "";
+
+  return (this->*generator)(node, arg, flow, format);
 }
 
 QString RozyneGenerator::generateTransitions(const NodeSaveInfo& node, const Argument& arg, const FlowSaveInfo& flow, const QString& format)
@@ -208,6 +212,7 @@ QString RozyneGenerator::generateComponent(const NodeSaveInfo& node, const QStri
     LOG_WARNING("Failed to open device for writing");
     return code;
   }
+  mWrittenFiles.push_back(QFileInfo(file).absoluteFilePath());
 
   // Generate child code
   // for (const auto& child : node.children)
@@ -15,17 +15,21 @@ public:
   QString generateCode(std::shared_ptr<SaveInfo> nodes) override;
   generator::Language supportedLanguage() const override;
   QString languageName() const override;
+  QStringList writtenFiles() const override;
 
 private:
   QDir mOutputFolder;
   std::shared_ptr<SaveInfo> mStorage;
   QVector<QString> mImports;
+  QStringList mWrittenFiles;
 
   struct Argument
   {
     QString name = "";
   };
 
+  using BehaviourGenerator = QString (RozyneGenerator::*)(const NodeSaveInfo&, const Argument&, const FlowSaveInfo&, const QString&);
+
   // Generic generators
   QString generateNode(const NodeSaveInfo& node);
   QString generateBehaviourNode(const NodeSaveInfo& node, const Argument& arg, const FlowSaveInfo& flow, const QString& format);
@@ -5,6 +5,7 @@
 BehaviourCanvas::BehaviourCanvas(Flow* flow, std::shared_ptr<SaveInfo> storage, std::shared_ptr<ConfigurationTable> configTable, QObject* parent)
     : Canvas(flow->id(), storage, configTable, parent)
     , mFlow(flow)
+    , mReleased(false)
 {
 }
 
@@ -13,6 +14,29 @@ Types::LibraryTypes BehaviourCanvas::type() const
   return Types::LibraryTypes::BEHAVIOUR;
 }
 
+void BehaviourCanvas::release()
+{
+  if (mReleased)
+    return;
+
+  releaseItems();
+  mReleased = true;
+}
+
+void BehaviourCanvas::restore()
+{
+  if (!mReleased)
+    return;
+
+  mReleased = false;
+  populate(mFlow);
+}
+
+bool BehaviourCanvas::isReleased() const
+{
+  return mReleased;
+}
+
 void BehaviourCanvas::updateParent(NodeItem* node, std::shared_ptr<NodeSaveInfo> storage, bool adding)
 {
   if (mFlow == nullptr)
@@ -11,8 +11,15 @@ public:
 
   Types::LibraryTypes type() const override;
 
+  // Inactive tabs can drop their items, the flow is all that is needed to
+  // bring them back
+  void release();
+  void restore();
+  bool isReleased() const;
+
 private:
   Flow* mFlow;
+  bool mReleased;
 
   void updateParent(NodeItem* node, std::shared_ptr<NodeSaveInfo> storage, bool adding) override;
 };
@@ -6,9 +6,12 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QMimeData>
+#include <QUuid>
+#include <functional>
 #include <memory>
 
 #include "app_configs.h"
+#include "canvas_commands.h"
 #include "canvas_view.h"
 #include "config.h"
 #include "config_table.h"
@@ -19,16 +22,23 @@
 #include "logging.h"
 #include "result.h"
 
+// Room left around the items before the scene rect has to grow
+static const qreal SCENE_MARGIN = 4096.0;
+
 Canvas::Canvas(const QString& canvasId, std::shared_ptr<SaveInfo> storage, std::shared_ptr<ConfigurationTable> configTable, QObject* parent)
     : QGraphicsScene(parent)
     , mId(canvasId)
-    , mCopiedNodes({})
+    , mUndoStack(Config::UNDO_MEMORY_BUDGET)
     , mConfigTable(configTable)
     , mStorage(storage)
 {
   setProperty("class", QVariant(QStringLiteral("canvas")));
   setBackgroundBrush(Qt::transparent);
 
+  // Qt's BSP index is kept for painting, it is sized by the scene rect which
+  // follows the extent of mIndex instead of growing forever
+  updateSceneRect();
+
   mHoverTimer = new QTimer(this);
   mHoverTimer->setSingleShot(true);
 }
@@ -71,46 +81,53 @@ void Canvas::dropEvent(QGraphicsSceneDragDropEvent* event)
 {
   if (event->mimeData()->hasFormat(Constants::TYPE_NODE))
   {
-    NodeItem* parentNode = nullptr;
-    QGraphicsItem* item = itemAt(event->scenePos(), QTransform());
-    if (item && item->type() == NodeItem::Type)
-    {
-      parentNode = static_cast<NodeItem*>(item);
-
-      // Add error message
-      if (!parentNode->acceptDrops())
-      {
-        LOG_WARNING("Tried to drop node on parent that does not accept drops");
-        return;
-      }
-    }
-
-    // Make sure that no other nodes are selected before dropping
-    clearSelectedNodes();
-
     QByteArray data = event->mimeData()->data(Constants::TYPE_NODE);
     QDataStream stream(&data, QIODevice::ReadOnly);
 
     auto info = std::make_shared<NodeSaveInfo>();
     stream >> *info;
-    info->scale = parentView()->getScale();
 
-    auto node = createNode(NodeCreation::Dropping, info, event->scenePos(), parentNode);
-    if (node)
-    {
-      selectNode(node, true);
+    if (dropNode(info, event->scenePos()))
       event->acceptProposedAction();
-    }
     else
-    {
       event->ignore();
-    }
 
     // Make sure we show that we are no longer dragging
     dynamic_cast<QGraphicsView*>(parent())->setCursor(Qt::ArrowCursor);
   }
 }
 
+NodeItem* Canvas::dropNode(std::shared_ptr<NodeSaveInfo> info, const QPointF& position)
+{
+  NodeItem* parentNode = nullptr;
+  QGraphicsItem* item = topItemAt(position);
+  if (item && item->type() == NodeItem::Type)
+  {
+    parentNode = static_cast<NodeItem*>(item);
+
+    // Add error message
+    if (!parentNode->acceptDrops())
+    {
+      LOG_WARNING("Tried to drop node on parent that does not accept drops");
+      return nullptr;
+    }
+  }
+
+  // Make sure that no other nodes are selected before dropping
+  clearSelectedNodes();
+
+  info->scale = parentView()->getScale();
+
+  auto node = createNode(NodeCreation::Dropping, info, position, parentNode);
+  if (node)
+  {
+    record(std::make_unique<AddItemsCommand>(this, QStringList{node->id()}, QStringList{}));
+    selectNode(node, true);
+  }
+
+  return node;
+}
+
 bool Canvas::isModifierSet(QGraphicsSceneMouseEvent* event, Qt::KeyboardModifier modifier)
 {
   return (event->modifiers() & modifier) > 0;
@@ -124,7 +141,7 @@ void Canvas::mousePressEvent(QGraphicsSceneMouseEvent* event)
   {
     mStartDragPosition = event->scenePos();
 
-    QGraphicsItem* item = itemAt(event->scenePos(), QTransform());
+    QGraphicsItem* item = topItemAt(event->scenePos());
     if (item && item->type() == NodeItem::Type)
     {
       if (!nodeClickHandler(event, item))
@@ -151,7 +168,25 @@ void Canvas::mousePressEvent(QGraphicsSceneMouseEvent* event)
     }
     else if (!item)
     {
-      clearSelectedNodes();
+      // Holding control adds the band to the current selection
+      bool adding = isModifierSet(event, Qt::ControlModifier);
+      if (!adding)
+        clearSelectedNodes();
+
+      if (parentView()->dragMode() == QGraphicsView::RubberBandDrag)
+      {
+        mBandKeep.clear();
+        if (adding)
+        {
+          for (QGraphicsItem* selected : selectedItems())
+            mBandKeep.insert(selected);
+        }
+
+        // Accepting the press keeps the view from starting its own rubber band
+        mRubberBanding = true;
+        event->accept();
+        return;
+      }
     }
   }
   else if (event->button() == Qt::MiddleButton)
@@ -160,6 +195,17 @@ void Canvas::mousePressEvent(QGraphicsSceneMouseEvent* event)
   }
 
   QGraphicsScene::mousePressEvent(event);
+
+  // Remember where the selection starts, the move is recorded on release
+  mMoveStart.clear();
+  if (event->button() == Qt::LeftButton)
+  {
+    for (QGraphicsItem* item : selectedItems())
+    {
+      if (item->type() == NodeItem::Type)
+        mMoveStart.insert(static_cast<NodeItem*>(item)->id(), item->pos());
+    }
+  }
 }
 
 bool Canvas::nodeClickHandler(QGraphicsSceneMouseEvent* event, QGraphicsItem* item)
@@ -224,6 +270,12 @@ void Canvas::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
   {
     mTransition->move(Constants::TMP_CONNECTION_ID, event->scenePos());
   }
+  else if (mRubberBanding)
+  {
+    updateRubberBand(event->scenePos());
+    event->accept();
+    return;
+  }
   // else if (event->buttons() & Qt::LeftButton)
   // {
   //   QList<QGraphicsItem*> draggedItems = selectedItems();
@@ -314,7 +366,7 @@ void Canvas::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
   {
     if (event->button() == Qt::LeftButton)
     {
-      QGraphicsItem* item = itemAt(event->scenePos(), QTransform());
+      QGraphicsItem* item = topItemAt(event->scenePos());
       LOG_INFO("Dropping transition: %d", item ? item->type() : -1);
       if (item && (item->type() == NodeItem::Type || item->type() == QGraphicsTextItem::Type))
       {
@@ -322,6 +374,8 @@ void Canvas::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
 
         mTransition->setEnd(node->id(), node->mapToScene(node->boundingRect().center()), {0, 0});
         mTransition->done(mNode, node);
+
+        record(std::make_unique<AddItemsCommand>(this, QStringList{}, QStringList{mTransition->id()}));
       }
       else
       {
@@ -332,28 +386,21 @@ void Canvas::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
       mNode = nullptr;
     }
   }
-  else
+  else if (mRubberBanding)
   {
-    if (parentView()->dragMode() == QGraphicsView::RubberBandDrag && !isModifierSet(event, Qt::ControlModifier))
-    {
-      bool draggingFromRight = mStartDragPosition.x() > event->scenePos().x();
-
-      QPainterPath selectionPath = selectionArea();
-      QList<QGraphicsItem*> allSelectedItems = selectedItems();
+    updateRubberBand(event->scenePos());
 
-      for (QGraphicsItem* item : selectedItems())
-      {
-        QRectF itemBounds = item->sceneBoundingRect();
-        if ((draggingFromRight && !selectionPath.intersects(itemBounds)) ||
-            (!draggingFromRight && !selectionPath.contains(itemBounds)))
-        {
-          item->setSelected(false);
-        }
-      }
-    }
+    mRubberBanding = false;
+    mBandSelection.clear();
+    mBandKeep.clear();
+    parentView()->hideRubberBand();
+    event->accept();
+    return;
   }
 
   QGraphicsScene::mouseReleaseEvent(event);  // Allow normal item drop behavior
+
+  recordMoves();
 }
 
 QMenu* Canvas::createAlignMenu(const QList<QGraphicsItem*>& items)
@@ -374,7 +421,7 @@ QMenu* Canvas::createAlignMenu(const QList<QGraphicsItem*>& items)
 
 void Canvas::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
 {
-  QGraphicsItem* item = itemAt(event->scenePos(), QTransform());
+  QGraphicsItem* item = topItemAt(event->scenePos());
   // For now, we do not support canvas context menu
   if (!item)
     return;
@@ -422,7 +469,7 @@ void Canvas::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
     });
 
     QAction* pasteAction = menu.addAction("Paste");
-    pasteAction->setEnabled(!mCopiedNodes.isEmpty());
+    pasteAction->setEnabled(hasCopiedNodes());
     QObject::connect(pasteAction, &QAction::triggered, [this]() {
       pasteCopiedItems();
     });
@@ -497,8 +544,8 @@ void Canvas::createTransitionContextMenu(QMenu& menu)
 void Canvas::deleteSelectedItems()
 {
   QList<QGraphicsItem*> items = selectedItems();
-  QList<NodeItem*> nodesToDelete;
-  QList<QGraphicsItem*> connectionsToDelete;
+  QStringList nodesToDelete;
+  QStringList connectionsToDelete;
 
   for (QGraphicsItem* item : items)
   {
@@ -512,29 +559,20 @@ void Canvas::deleteSelectedItems()
 
       // Only delete if no parent OR parent is not selected
       if (!parent || !parent->isSelected())
-        nodesToDelete.append(node);
+        nodesToDelete.append(node->id());
     }
     else if (item->type() == TransitionItem::Type)
     {
       TransitionItem* transition = static_cast<TransitionItem*>(item);
       if (!(transition->source() && transition->source()->isSelected()) && !(transition->destination() && transition->destination()->isSelected()))
-        connectionsToDelete.append(item);
+        connectionsToDelete.append(transition->id());
     }
   }
 
-  // First delete the connections
-  for (QGraphicsItem* connection : connectionsToDelete)
-  {
-    removeItem(connection);
-    delete connection;
-  }
+  if (nodesToDelete.isEmpty() && connectionsToDelete.isEmpty())
+    return;
 
-  // Then delete the nodes
-  for (NodeItem* node : nodesToDelete)
-  {
-    updateParent(node, nullptr, false);
-    node->deleteNode();
-  }
+  mUndoStack.execute(std::make_unique<RemoveItemsCommand>(this, nodesToDelete, connectionsToDelete));
 }
 
 bool Canvas::isParentSelected(NodeItem* node)
@@ -548,10 +586,10 @@ bool Canvas::isParentSelected(NodeItem* node)
 
 void Canvas::copySelectedItems()
 {
-  mCopiedNodes.clear();
-
   QPointF mousePosition = parentView()->mapToScene(parentView()->mapFromGlobal(QCursor::pos()));
 
+  QVector<std::shared_ptr<NodeSaveInfo>> nodes;
+  QVector<QPointF> offsets;
   for (QGraphicsItem* item : selectedItems())
   {
     if (item->type() != NodeItem::Type)
@@ -566,42 +604,127 @@ void Canvas::copySelectedItems()
       continue;
 
     // Save relative position
-    auto info = node->saveInfo();
-    mCopiedNodes.append({info, mousePosition - info.position});
+    nodes.push_back(node->storage());
+    offsets.push_back(mousePosition - node->sceneBoundingRect().center());
 
     // Make sure the item is not selected after copying
     selectNode(node, false);
   }
+
+  if (nodes.isEmpty())
+    return;
+
+  // Encoding detaches the copy from the live storage in one go, the encoded
+  // data is then shared as is until it is decoded by a paste
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_6_0);
+  stream << SAVE_MAGIC << SAVE_FORMAT_VERSION;
+  stream << nodes << offsets;
+
+  mCopiedNodes = data;
+
+  QMimeData* mimeData = new QMimeData();
+  mimeData->setData(Constants::TYPE_NODES, data);
+  QApplication::clipboard()->setMimeData(mimeData);
 }
 
-void Canvas::pasteCopiedItems(const QPointF& mousePosition, NodeItem* parentNode, QList<CopiedNode> copiedNodes, bool absolute)
+bool Canvas::hasCopiedNodes() const
 {
-  for (const auto& copy : copiedNodes)
-  {
-    auto infoPtr = std::make_shared<NodeSaveInfo>(copy.info);
-    auto node = createNode(NodeCreation::Pasting,
-                           infoPtr,
-                           absolute ? mousePosition - copy.posRelativeToMouse : copy.info.position,
-                           parentNode);
+  // Only checks the formats, the data itself is fetched when pasting
+  const QMimeData* mimeData = QApplication::clipboard()->mimeData();
+  return (mimeData && mimeData->hasFormat(Constants::TYPE_NODES)) || !mCopiedNodes.isEmpty();
+}
+
+QByteArray Canvas::copiedNodes() const
+{
+  // Prefer the system clipboard so that nodes copied in another editor can be pasted
+  const QMimeData* mimeData = QApplication::clipboard()->mimeData();
+  if (mimeData && mimeData->hasFormat(Constants::TYPE_NODES))
+    return mimeData->data(Constants::TYPE_NODES);
 
-    QList<CopiedNode> children;
-    for (const auto& child : copy.info.children)
-      children.push_back({*child});
+  return mCopiedNodes;
+}
 
-    pasteCopiedItems(mousePosition, node, children, false);
-    selectNode(node, false);
+// Gives the pasted nodes, their flows and their transitions new ids in a single
+// walk over the decoded tree. The transitions between nodes of this canvas are
+// taken out of the nodes and returned, they are created once the nodes exist.
+static QVector<std::shared_ptr<TransitionSaveInfo>> remapIds(const QVector<std::shared_ptr<NodeSaveInfo>>& nodes)
+{
+  QHash<QString, QString> ids;
+  QVector<std::shared_ptr<TransitionSaveInfo>> transitions;
+  QVector<std::shared_ptr<NodeSaveInfo>> flowNodes;
+
+  std::function<void(const std::shared_ptr<NodeSaveInfo>&, bool)> visit = [&](const std::shared_ptr<NodeSaveInfo>& info, bool inCanvas) {
+    QString id = QUuid::createUuid().toString();
+    ids.insert(info->id, id);
+    info->id = id;
+
+    if (inCanvas)
+    {
+      transitions += info->transitions;
+      info->transitions.clear();
+    }
+    else
+    {
+      flowNodes.push_back(info);
+    }
+
+    for (const auto& child : info->children)
+    {
+      child->parentId = id;
+      visit(child, inCanvas);
+    }
+
+    for (const auto& flow : info->flows)
+    {
+      flow->id = QUuid::createUuid().toString();
+      flow->owner = id;
+      for (const auto& node : flow->nodes)
+        visit(node, false);
+    }
+
+    if (info->behaviour)
+    {
+      for (const auto& node : info->behaviour->nodes)
+        visit(node, false);
+    }
+  };
+
+  for (const auto& info : nodes)
+    visit(info, true);
+
+  // Transitions to nodes that were not copied are dropped
+  auto rewire = [&ids](const std::shared_ptr<TransitionSaveInfo>& transition) {
+    if (!ids.contains(transition->srcId) || !ids.contains(transition->dstId))
+      return false;
+
+    transition->id = QUuid::createUuid().toString();
+    transition->srcId = ids.value(transition->srcId);
+    transition->dstId = ids.value(transition->dstId);
+    return true;
+  };
+
+  transitions.removeIf([&rewire](const auto& transition) { return !rewire(transition); });
+  for (const auto& node : flowNodes)
+  {
+    node->parentId = ids.value(node->parentId);
+    node->transitions.removeIf([&rewire](const auto& transition) { return !rewire(transition); });
   }
+
+  return transitions;
 }
 
 void Canvas::pasteCopiedItems()
 {
-  if (mCopiedNodes.isEmpty())
+  QByteArray data = copiedNodes();
+  if (data.isEmpty())
     return;
 
   QPointF mousePosition = parentView()->mapToScene(parentView()->mapFromGlobal(QCursor::pos()));
 
   NodeItem* parentNode = nullptr;
-  QGraphicsItem* item = itemAt(mousePosition, QTransform());
+  QGraphicsItem* item = topItemAt(mousePosition);
   if (item && item->type() == NodeItem::Type)
   {
     parentNode = static_cast<NodeItem*>(item);
@@ -611,7 +734,57 @@ void Canvas::pasteCopiedItems()
       return;
   }
 
-  pasteCopiedItems(mousePosition, parentNode, mCopiedNodes, true);
+  // Decoding is the only copy made of the clipboard
+  QVector<std::shared_ptr<NodeSaveInfo>> nodes;
+  QVector<QPointF> offsets;
+  QDataStream stream(data);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  // Nodes copied by another version of the editor may have a different layout
+  quint32 magic = 0;
+  quint32 version = 0;
+  stream >> magic >> version;
+  if (magic != SAVE_MAGIC || version != SAVE_FORMAT_VERSION)
+  {
+    LOG_WARNING("The clipboard contains nodes from an incompatible version");
+    return;
+  }
+
+  stream >> nodes >> offsets;
+
+  if (stream.status() != QDataStream::Ok || nodes.size() != offsets.size())
+  {
+    LOG_WARNING("The clipboard does not contain valid nodes");
+    return;
+  }
+
+  auto transitions = remapIds(nodes);
+
+  for (int i = 0; i < nodes.size(); ++i)
+  {
+    QPointF position = mousePosition - offsets[i];
+    nodes[i]->position = parentNode ? parentNode->mapFromScene(position) : position;
+    nodes[i]->parentId = parentNode ? parentNode->id() : QString();
+  }
+
+  beginBulkCreation();
+
+  LOG_WARN_ON_FAILURE(loadFromSave(nodes, parentNode));
+  for (const auto& transition : transitions)
+    createTransition(transition);
+
+  endBulkCreation();
+
+  // Undoing the top level nodes takes their children with them
+  QStringList ids;
+  for (const auto& node : nodes)
+  {
+    if (findNodeWithId(node->id))
+      ids.push_back(node->id);
+  }
+
+  if (!ids.isEmpty())
+    record(std::make_unique<AddItemsCommand>(this, ids, QStringList{}));
 }
 
 void Canvas::clearCanvas()
@@ -629,8 +802,33 @@ void Canvas::clearCanvas()
     if (node->parentNode())
       continue;
 
-    node->deleteNode();
+    deleteNode(node);
+  }
+}
+
+void Canvas::releaseItems()
+{
+  mHoveredNode = nullptr;
+  mTransition = nullptr;
+  mNode = nullptr;
+  mRubberBanding = false;
+
+  // Transitions remove themselves from their nodes when deleted
+  for (QGraphicsItem* item : items())
+  {
+    if (item->type() == TransitionItem::Type)
+      static_cast<TransitionItem*>(item)->detach();
   }
+
+  mIndex.clear();
+  mNodes.clear();
+  mMoveStart.clear();
+  mBandSelection.clear();
+  mBandKeep.clear();
+  mDirtyTransitions.clear();
+  mPendingIndex.clear();
+
+  clear();
 }
 
 void Canvas::selectNode(NodeItem* node, bool select)
@@ -657,6 +855,54 @@ void Canvas::clearSelectedNodes()
   selectNode(nullptr, false);
 }
 
+void Canvas::updateRubberBand(const QPointF& position)
+{
+  QRectF area = QRectF(mStartDragPosition, position).normalized();
+  parentView()->showRubberBand(area);
+
+  // Dragging to the right selects what is fully inside the band, dragging to
+  // the left selects everything the band touches
+  bool intersecting = mStartDragPosition.x() > position.x();
+
+  QSet<QGraphicsItem*> selection;
+  for (QGraphicsItem* item : mIndex.query(area))
+  {
+    if (!(item->flags() & QGraphicsItem::ItemIsSelectable) || !item->isVisible())
+      continue;
+
+    // Items selected before the band started stay selected either way
+    if (mBandKeep.contains(item))
+      continue;
+
+    QRectF bounds = item->sceneBoundingRect();
+    if (intersecting ? area.intersects(bounds) : area.contains(bounds))
+      selection.insert(item);
+  }
+
+  if (selection == mBandSelection)
+    return;
+
+  // Only touch the items that entered or left the band, and notify once for
+  // all of them instead of once per item
+  {
+    QSignalBlocker blocker(this);
+    for (QGraphicsItem* item : std::as_const(mBandSelection))
+    {
+      if (!selection.contains(item))
+        item->setSelected(false);
+    }
+
+    for (QGraphicsItem* item : std::as_const(selection))
+    {
+      if (!item->isSelected())
+        item->setSelected(true);
+    }
+  }
+
+  mBandSelection = selection;
+  emit selectionChanged();
+}
+
 VoidResult Canvas::loadFromSave(const QVector<std::shared_ptr<NodeSaveInfo>>& nodes, NodeItem* parent)
 {
   for (std::shared_ptr<NodeSaveInfo> nodeInfo : nodes)
@@ -667,6 +913,8 @@ VoidResult Canvas::loadFromSave(const QVector<std::shared_ptr<NodeSaveInfo>>& no
 
     LOG_DEBUG("Creating node %s with parent %s", qPrintable(node->id), qPrintable(node->parentId));
     auto createdNode = createNode(NodeCreation::Loading, node, node->position, parent);
+    if (!createdNode)
+      continue;
 
     LOG_AND_RETURN_VOID_ON_FAILURE(loadFromSave(nodeInfo->children, createdNode));
 
@@ -685,6 +933,7 @@ VoidResult Canvas::loadFromSave(const SaveInfo& info)
 {
   // Clear the canvas before repopulating
   clearCanvas();
+  mUndoStack.clear();
 
   // Reset canvas
   // TODO(felaze): This should be moved to the CanvasView, something like parentView()->loadFromSave(info.canvasInfo);
@@ -692,7 +941,11 @@ VoidResult Canvas::loadFromSave(const SaveInfo& info)
   parentView()->setScale(info.canvasInfo.scale);
   parentView()->centerOn(info.canvasInfo.center);
 
-  return loadFromSave(info.structuralNodes, nullptr);
+  beginBulkCreation();
+  auto result = loadFromSave(info.structuralNodes, nullptr);
+  endBulkCreation();
+
+  return result;
 }
 
 CanvasView* Canvas::parentView() const
@@ -700,9 +953,39 @@ CanvasView* Canvas::parentView() const
   return static_cast<CanvasView*>(parent());
 }
 
+void Canvas::beginBulkCreation()
+{
+  if (mBulkDepth++ > 0)
+    return;
+
+  parentView()->setUpdatesEnabled(false);
+}
+
+void Canvas::endBulkCreation()
+{
+  if (--mBulkDepth > 0)
+    return;
+
+  auto pending = std::move(mPendingIndex);
+  mPendingIndex.clear();
+  for (QGraphicsItem* item : std::as_const(pending))
+    indexItem(item);
+
+  parentView()->setUpdatesEnabled(true);
+
+  auto nodes = std::move(mBulkNodes);
+  mBulkNodes.clear();
+  if (!nodes.isEmpty())
+    emit nodesAdded(nodes);
+}
+
 NodeItem* Canvas::createNode(NodeCreation creation, std::shared_ptr<NodeSaveInfo> info, const QPointF& position, NodeItem* parent)
 {
-  auto config = mConfigTable->get(info->nodeId);
+  // Infos built by hand may not have resolved their type yet
+  if (!info->type.isValid())
+    info->type = Symbol::find(info->nodeId);
+
+  auto config = mConfigTable->get(info->type);
   if (config == nullptr)
   {
     LOG_WARNING("Added node with no configuration");
@@ -717,19 +1000,18 @@ NodeItem* Canvas::createNode(NodeCreation creation, std::shared_ptr<NodeSaveInfo
 
   // If no parent is defined, we must create a "base node" in the canvas
   NodeItem* node = nullptr;
-  auto nodeId = creation == NodeCreation::Pasting ? "" : info->id;
   if (parent == nullptr)
   {
     if (type() == Types::LibraryTypes::STRUCTURAL)
       mStorage->structuralNodes.append(info);
 
-    node = new NodeItem(nodeId, info, position, config);
+    node = new NodeItem(info->id, info, position, config);
   }
   // If it is defined, we simply add a child node to the parent
   else
   {
     QPointF pos = creation == NodeCreation::Dropping ? parent->mapFromScene(position) : position;
-    node = new NodeItem(nodeId, info, pos, config, parent);
+    node = new NodeItem(info->id, info, pos, config, parent);
 
     parent->addChild(node, info);
   }
@@ -743,33 +1025,89 @@ NodeItem* Canvas::createNode(NodeCreation creation, std::shared_ptr<NodeSaveInfo
     emit nodeRemoved(item);
   };
   node->flowAdded = [this](Flow* flow, NodeItem* node) {
+    for (const auto& info : node->events())
+    {
+      if (info->id == flow->id())
+        record(std::make_unique<FlowCommand>(this, node->id(), info, true));
+    }
+
     emit flowAdded(flow, node);
   };
 
   node->start();
+  mNodes.insert(node->id(), node);
 
   // Do not add child nodes to the scene
   if (parent == nullptr)
     addItem(node);
 
+  indexItem(node);
+
   if (creation != NodeCreation::Populating)
     updateParent(node, info, true);
 
-  emit nodeAdded(node);
+  if (mBulkDepth > 0)
+    mBulkNodes.push_back(node);
+  else
+    emit nodeAdded(node);
 
   return node;
 }
 
+TransitionItem* Canvas::createTransition(std::shared_ptr<TransitionSaveInfo> info)
+{
+  auto source = findNodeWithId(info->srcId);
+  auto destination = findNodeWithId(info->dstId);
+  if (!source || !destination)
+  {
+    LOG_WARNING("Could not find the nodes of transition %s -> %s", qPrintable(info->srcId), qPrintable(info->dstId));
+    return nullptr;
+  }
+
+  LOG_DEBUG("Creating transitions %s -> %s", qPrintable(info->srcId), qPrintable(info->dstId));
+
+  auto connection = new TransitionItem(info);
+
+  connection->setStart(info->srcId, info->srcPoint, info->srcShift);
+  connection->setEnd(info->dstId, info->dstPoint, info->dstShift);
+
+  connection->done(source, destination);
+
+  addItem(connection);
+
+  return connection;
+}
+
+void Canvas::deleteNode(NodeItem* node)
+{
+  updateParent(node, nullptr, false);
+
+  // Root nodes are added to the storage on creation, children are removed by their parent
+  if (!node->parentNode() && type() == Types::LibraryTypes::STRUCTURAL)
+  {
+    mStorage->structuralNodes.removeIf([node](std::shared_ptr<NodeSaveInfo> info) {
+      return info->id == node->id();
+    });
+  }
+
+  node->deleteNode();
+}
+
 NodeItem* Canvas::findNodeWithId(const QString& id) const
+{
+  return mNodes.value(id, nullptr);
+}
+
+TransitionItem* Canvas::findTransitionWithId(const QString& id) const
 {
   for (const auto& item : items())
   {
-    if (item->type() != NodeItem::Type)
+    if (item->type() != TransitionItem::Type)
       continue;
 
-    auto node = static_cast<NodeItem*>(item);
-    if (node->id() == id)
-      return node;
+    auto transition = static_cast<TransitionItem*>(item);
+    if (transition->id() == id)
+      return transition;
   }
 
   return nullptr;
@@ -799,9 +1137,8 @@ void Canvas::onFocusNode(const QString& nodeId)
 
 void Canvas::onRemoveNode(const QString& nodeId)
 {
-  auto node = findNodeWithId(nodeId);
-  if (node)
-    node->deleteNode();
+  if (findNodeWithId(nodeId))
+    mUndoStack.execute(std::make_unique<RemoveItemsCommand>(this, QStringList{nodeId}, QStringList{}));
 }
 
 void Canvas::onSelectNode(const QList<QString>& nodeIds)
@@ -825,10 +1162,323 @@ void Canvas::onRenameNode(const QString& nodeId, const QString& name)
     node->setProperty("name", name);
 }
 
+// ==========================================================================================
+// Undo
+void Canvas::undo()
+{
+  mUndoStack.undo();
+}
+
+void Canvas::redo()
+{
+  mUndoStack.redo();
+}
+
+bool Canvas::isRecording() const
+{
+  return mBulkDepth == 0 && !mUndoStack.isApplying();
+}
+
+void Canvas::record(std::unique_ptr<Command> command)
+{
+  if (isRecording())
+    mUndoStack.push(std::move(command));
+}
+
+void Canvas::recordMoves()
+{
+  QVector<MoveNodesCommand::Move> moves;
+  for (auto start = mMoveStart.cbegin(); start != mMoveStart.cend(); ++start)
+  {
+    auto node = findNodeWithId(start.key());
+    if (node && node->pos() != start.value())
+      moves.push_back({start.key(), start.value(), node->pos()});
+  }
+
+  mMoveStart.clear();
+
+  if (!moves.isEmpty())
+    record(std::make_unique<MoveNodesCommand>(this, moves));
+}
+
+void Canvas::recordPropertyChange(NodeItem* node, const QString& key, const QVariant& from, const QVariant& to)
+{
+  if (from != to)
+    record(std::make_unique<SetPropertyCommand>(this, node->id(), key, from, to));
+}
+
+void Canvas::recordFieldChange(NodeItem* node, const QString& key, const std::optional<PropertiesConfig>& from, const std::optional<PropertiesConfig>& to)
+{
+  record(std::make_unique<SetFieldCommand>(this, node->id(), key, from, to));
+}
+
+void Canvas::recordResize(NodeItem* node, const QSizeF& fromSize, qreal fromScale)
+{
+  QSizeF size = node->boundingRect().size();
+  if (size != fromSize)
+    record(std::make_unique<ResizeNodeCommand>(this, node->id(), fromSize, fromScale, size, node->baseScale()));
+}
+
+QByteArray Canvas::snapshotItems(const QStringList& nodeIds, const QStringList& transitionIds) const
+{
+  QVector<std::shared_ptr<NodeSaveInfo>> nodes;
+  QVector<std::shared_ptr<TransitionSaveInfo>> transitions;
+  QSet<QString> seen;
+
+  auto addTransition = [&](TransitionItem* transition) {
+    if (seen.contains(transition->id()))
+      return;
+
+    seen.insert(transition->id());
+    transitions.push_back(transition->storage());
+  };
+
+  // Transitions of the children go away with them as well
+  std::function<void(NodeItem*)> collect = [&](NodeItem* node) {
+    for (TransitionItem* transition : node->transitions())
+      addTransition(transition);
+
+    for (INode* child : node->children())
+      collect(static_cast<NodeItem*>(child));
+  };
+
+  for (const auto& id : nodeIds)
+  {
+    auto node = findNodeWithId(id);
+    if (!node)
+      continue;
+
+    nodes.push_back(node->storage());
+    collect(node);
+  }
+
+  for (const auto& id : transitionIds)
+  {
+    auto transition = findTransitionWithId(id);
+    if (transition)
+      addTransition(transition);
+  }
+
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream << nodes << transitions;
+
+  return data;
+}
+
+void Canvas::removeItems(const QStringList& nodeIds, const QStringList& transitionIds)
+{
+  // First delete the connections
+  for (const auto& id : transitionIds)
+  {
+    auto transition = findTransitionWithId(id);
+    if (!transition)
+      continue;
+
+    removeItem(transition);
+    delete transition;
+  }
+
+  // Then delete the nodes
+  for (const auto& id : nodeIds)
+  {
+    auto node = findNodeWithId(id);
+    if (node)
+      deleteNode(node);
+  }
+}
+
+void Canvas::restoreItems(const QByteArray& snapshot)
+{
+  QVector<std::shared_ptr<NodeSaveInfo>> nodes;
+  QVector<std::shared_ptr<TransitionSaveInfo>> transitions;
+
+  QDataStream stream(snapshot);
+  stream >> nodes >> transitions;
+
+  // The transitions are recreated once all their nodes exist
+  std::function<void(const std::shared_ptr<NodeSaveInfo>&)> stripTransitions = [&](const std::shared_ptr<NodeSaveInfo>& info) {
+    info->transitions.clear();
+    for (const auto& child : info->children)
+      stripTransitions(child);
+  };
+
+  beginBulkCreation();
+
+  for (const auto& info : nodes)
+  {
+    stripTransitions(info);
+
+    NodeItem* parent = info->parentId.isEmpty() ? nullptr : findNodeWithId(info->parentId);
+    LOG_WARN_ON_FAILURE(loadFromSave({info}, parent));
+  }
+
+  for (const auto& transition : transitions)
+    createTransition(transition);
+
+  endBulkCreation();
+}
+
+// ==========================================================================================
+// Spatial index
+static QGraphicsItem* hitTest(QGraphicsItem* item, const QPointF& position)
+{
+  if (!item->isVisible())
+    return nullptr;
+
+  // Labels are children of the item, so they are stacked above it
+  for (QGraphicsItem* child : item->childItems())
+  {
+    if (child->type() == QGraphicsTextItem::Type && child->isVisible() && child->contains(child->mapFromScene(position)))
+      return child;
+  }
+
+  if (item->contains(item->mapFromScene(position)))
+    return item;
+
+  return nullptr;
+}
+
+bool Canvas::isStackedAbove(const QGraphicsItem* item, const QGraphicsItem* other) const
+{
+  // Children are always drawn on top of their parents
+  if (item->isAncestorOf(other))
+    return false;
+  if (other->isAncestorOf(item))
+    return true;
+
+  // Otherwise compare the branches right below the common ancestor
+  const QGraphicsItem* common = item->commonAncestorItem(other);
+  auto branch = [common](const QGraphicsItem* current) {
+    while (current->parentItem() != common)
+      current = current->parentItem();
+    return current;
+  };
+
+  const QGraphicsItem* itemBranch = branch(item);
+  const QGraphicsItem* otherBranch = branch(other);
+  if (itemBranch->zValue() != otherBranch->zValue())
+    return itemBranch->zValue() > otherBranch->zValue();
+
+  // Qt breaks ties by insertion order, which is not exposed, so use the order
+  // they were indexed in. Labels are not indexed, but they are created first.
+  return mIndex.order(itemBranch) > mIndex.order(otherBranch);
+}
+
+QGraphicsItem* Canvas::topItemAt(const QPointF& position) const
+{
+  QGraphicsItem* top = nullptr;
+  for (QGraphicsItem* candidate : mIndex.query(position))
+  {
+    QGraphicsItem* hit = hitTest(candidate, position);
+    if (hit && (top == nullptr || isStackedAbove(hit, top)))
+      top = hit;
+  }
+
+  return top;
+}
+
+void Canvas::indexItem(QGraphicsItem* item)
+{
+  if (mBulkDepth > 0)
+  {
+    mPendingIndex.insert(item);
+    return;
+  }
+
+  // Include the labels hanging outside the item so that they can be hit. Child
+  // nodes are indexed on their own, adding them here would go stale as they move.
+  QRectF bounds = item->sceneBoundingRect();
+  for (QGraphicsItem* child : item->childItems())
+  {
+    if (child->type() == QGraphicsTextItem::Type)
+      bounds = bounds.united(child->sceneBoundingRect());
+  }
+
+  mIndex.insert(item, bounds);
+  scheduleSceneRectUpdate();
+}
+
+void Canvas::unindexItem(QGraphicsItem* item)
+{
+  // A deleted node may outlive the one restored with its id
+  if (item->type() == NodeItem::Type)
+  {
+    auto node = mNodes.find(static_cast<NodeItem*>(item)->id());
+    if (node != mNodes.end() && *node == item)
+      mNodes.erase(node);
+  }
+
+  mIndex.remove(item);
+  scheduleSceneRectUpdate();
+  mBandSelection.remove(item);
+  mBandKeep.remove(item);
+  mPendingIndex.remove(item);
+
+  if (item->type() == TransitionItem::Type)
+    mDirtyTransitions.remove(static_cast<TransitionItem*>(item));
+}
+
+void Canvas::scheduleTransitionUpdate(TransitionItem* transition)
+{
+  mDirtyTransitions.insert(transition);
+  if (mTransitionUpdateQueued)
+    return;
+
+  // Queued behind the scene's own dirty item processing, so the paths are
+  // up to date before the next paint
+  mTransitionUpdateQueued = true;
+  QMetaObject::invokeMethod(this, &Canvas::updateTransitions, Qt::QueuedConnection);
+}
+
+void Canvas::updateTransitions()
+{
+  mTransitionUpdateQueued = false;
+
+  auto dirty = std::move(mDirtyTransitions);
+  mDirtyTransitions.clear();
+
+  for (TransitionItem* transition : std::as_const(dirty))
+    transition->updatePath();
+}
+
+void Canvas::scheduleSceneRectUpdate()
+{
+  if (mSceneRectUpdateQueued)
+    return;
+
+  mSceneRectUpdateQueued = true;
+  QMetaObject::invokeMethod(this, &Canvas::updateSceneRect, Qt::QueuedConnection);
+}
+
+void Canvas::updateSceneRect()
+{
+  mSceneRectUpdateQueued = false;
+
+  QRectF extent = mIndex.extent();
+  QRectF wanted = extent.adjusted(-SCENE_MARGIN, -SCENE_MARGIN, SCENE_MARGIN, SCENE_MARGIN);
+  QRectF current = sceneRect();
+
+  // Changing the scene rect rebuilds the BSP tree, so only do it once the items
+  // leave the current rect or it has become much larger than they need
+  bool outside = !current.contains(extent);
+  bool oversized = current.width() * current.height() > 4 * wanted.width() * wanted.height();
+  if (mSceneRectSet && !outside && !oversized)
+    return;
+
+  mSceneRectSet = true;
+  setSceneRect(wanted);
+
+  for (QGraphicsView* view : views())
+    static_cast<CanvasView*>(view)->setPanArea(wanted);
+}
+
 // ==========================================================================================
 // Flow
 void Canvas::populate(Flow* flow)
 {
+  beginBulkCreation();
+
   // First create all the nodes
   for (std::shared_ptr<NodeSaveInfo> node : flow->getNodes())
   {
@@ -848,26 +1498,10 @@ void Canvas::populate(Flow* flow)
     }
 
     for (const auto& transition : node->transitions)
-    {
-      auto dstConn = findNodeWithId(transition->dstId);
-      if (!dstConn)
-      {
-        LOG_WARNING("Could not find destination node");
-        continue;
-      }
-
-      LOG_DEBUG("Creating transitions %s -> %s", qPrintable(node->id), qPrintable(transition->dstId));
-
-      auto connection = new TransitionItem(transition);
-
-      connection->setStart(node->id, transition->srcPoint, transition->srcShift);
-      connection->setEnd(transition->dstId, transition->dstPoint, transition->dstShift);
-
-      connection->done(srcConn, dstConn);
-
-      addItem(connection);
-    }
+      createTransition(transition);
   }
+
+  endBulkCreation();
 }
 
 void Canvas::onFlowSelected(const QString& flowId, const QString& nodeId)
@@ -892,6 +1526,12 @@ void Canvas::onFlowRemoved(const QString& flowId, const QString& nodeId)
     return;
   }
 
+  for (const auto& info : node->events())
+  {
+    if (info->id == flowId)
+      record(std::make_unique<FlowCommand>(this, nodeId, info, false));
+  }
+
   node->deleteFlow(flowId);
   emit flowRemoved(flowId, node);
 }
@@ -902,8 +1542,11 @@ void Canvas::updateParent(NodeItem* /* node */, std::shared_ptr<NodeSaveInfo> /*
 
 void Canvas::themeChanged()
 {
-  for (QGraphicsItem* item : items())
-  {
-    item->update();
-  }
+  // Nodes are cached, so they must be told to paint again with the new colors.
+  // Everything else reads the theme when painted, repainting the views is enough.
+  for (NodeItem* node : std::as_const(mNodes))
+    node->update();
+
+  for (QGraphicsView* view : views())
+    view->viewport()->update();
 }
\ No newline at end of file
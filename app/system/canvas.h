@@ -5,12 +5,17 @@
 #include <QGraphicsItem>
 #include <QGraphicsScene>
 #include <QGraphicsView>
+#include <QHash>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QSet>
 #include <QTimer>
+#include <optional>
 
 #include "elements/node.h"
 #include "elements/save_info.h"
+#include "spatial_index.h"
+#include "undo_stack.h"
 
 class CanvasView;
 class TransitionItem;
@@ -39,6 +44,34 @@ public:
 
   void themeChanged();
 
+  // Creates a node from the library as if it was dropped at the given position
+  NodeItem* dropNode(std::shared_ptr<NodeSaveInfo> info, const QPointF& position);
+
+  // Hit testing goes through our own index, the scene index is disabled since
+  // nodes move all the time
+  QGraphicsItem* topItemAt(const QPointF& position) const;
+  void indexItem(QGraphicsItem* item);
+  void unindexItem(QGraphicsItem* item);
+
+  // Transition paths are rebuilt once per frame instead of once per moved node
+  void scheduleTransitionUpdate(TransitionItem* transition);
+
+  void undo();
+  void redo();
+
+  // Edits made outside of the canvas that should end up in the undo history
+  void recordPropertyChange(NodeItem* node, const QString& key, const QVariant& from, const QVariant& to);
+  void recordFieldChange(NodeItem* node, const QString& key, const std::optional<PropertiesConfig>& from, const std::optional<PropertiesConfig>& to);
+  void recordResize(NodeItem* node, const QSizeF& fromSize, qreal fromScale);
+
+  // Used by the undo commands, items are always looked up by id since they are
+  // recreated when a deletion is undone
+  NodeItem* findNodeWithId(const QString& id) const;
+  TransitionItem* findTransitionWithId(const QString& id) const;
+  QByteArray snapshotItems(const QStringList& nodeIds, const QStringList& transitionIds) const;
+  void removeItems(const QStringList& nodeIds, const QStringList& transitionIds);
+  void restoreItems(const QByteArray& snapshot);
+
 protected:
   void
   dragEnterEvent(QGraphicsSceneDragDropEvent* event) override;
@@ -53,9 +86,13 @@ protected:
 
   virtual void updateParent(NodeItem* node, std::shared_ptr<NodeSaveInfo> storage, bool adding);
 
+  // Deletes all the items but leaves the storage as it is
+  void releaseItems();
+
 signals:
   void nodeSelected(NodeItem* node, bool selected);
   void nodeAdded(NodeItem* node);
+  void nodesAdded(const QList<NodeItem*>& nodes);
   void nodeRemoved(NodeItem* node);
   void nodeModified(NodeItem* node);
 
@@ -79,7 +116,6 @@ private:
   enum class NodeCreation
   {
     Dropping,
-    Pasting,
     Loading,
     Populating
   };
@@ -89,20 +125,35 @@ private:
   NodeItem* mNode = nullptr;
   QPointF mStartDragPosition;
 
+  bool mRubberBanding = false;
+  QSet<QGraphicsItem*> mBandSelection;
+  // Selected before a control drag started, the band does not deselect them
+  QSet<QGraphicsItem*> mBandKeep;
+
+  bool mTransitionUpdateQueued = false;
+  QSet<TransitionItem*> mDirtyTransitions;
+
+  bool mSceneRectSet = false;
+  bool mSceneRectUpdateQueued = false;
+
+  // Bulk creation, see beginBulkCreation
+  int mBulkDepth = 0;
+  QList<NodeItem*> mBulkNodes;
+  QSet<QGraphicsItem*> mPendingIndex;
+
   int mFrontZValue = 5;
   int mBackZValue = -5;
 
   QTimer* mHoverTimer;
 
-  struct CopiedNode
-  {
-    NodeSaveInfo info;
-    QPointF posRelativeToMouse;
-  };
-
   const QString mId;
 
-  QList<CopiedNode> mCopiedNodes;
+  // Copied nodes in the binary save encoding, also exported to the system clipboard
+  QByteArray mCopiedNodes;
+  SpatialIndex mIndex;
+  QHash<QString, NodeItem*> mNodes;
+  UndoStack mUndoStack;
+  QHash<QString, QPointF> mMoveStart;
   std::shared_ptr<ConfigurationTable> mConfigTable;
   std::shared_ptr<SaveInfo> mStorage;
 
@@ -110,15 +161,34 @@ private:
   void selectNode(NodeItem* node, bool select);
 
   CanvasView* parentView() const;
+
+  // While creating many nodes at once, indexing and view updates are held back
+  // and a single nodesAdded is emitted at the end instead of a nodeAdded per node
+  void beginBulkCreation();
+  void endBulkCreation();
   NodeItem* createNode(NodeCreation creation, std::shared_ptr<NodeSaveInfo> info, const QPointF& position, NodeItem* parent);
+  TransitionItem* createTransition(std::shared_ptr<TransitionSaveInfo> info);
+  void deleteNode(NodeItem* node);
 
-  NodeItem* findNodeWithId(const QString& id) const;
+  // Commands are only recorded for edits made by the user
+  bool isRecording() const;
+  void record(std::unique_ptr<Command> command);
+  void recordMoves();
 
   // Context menu
   // TODO(felaze): Make this a separate class
   QMenu* createAlignMenu(const QList<QGraphicsItem*>& items);
 
+  // Follows the stacking order Qt paints with
+  bool isStackedAbove(const QGraphicsItem* item, const QGraphicsItem* other) const;
+
   void clearSelectedNodes();
+  void updateRubberBand(const QPointF& position);
+  void updateTransitions();
+
+  // Fits the scene rect to the indexed items, which bounds the BSP tree Qt paints with
+  void scheduleSceneRectUpdate();
+  void updateSceneRect();
   bool isModifierSet(QGraphicsSceneMouseEvent* event, Qt::KeyboardModifier modifier);
 
   bool nodeClickHandler(QGraphicsSceneMouseEvent* event, QGraphicsItem* item);
@@ -128,7 +198,8 @@ private:
   void createTransitionContextMenu(QMenu& menu);
 
   bool isParentSelected(NodeItem* node);
-  void pasteCopiedItems(const QPointF& mousePosition, NodeItem* parentNode, QList<CopiedNode> nodes, bool relative);
+  bool hasCopiedNodes() const;
+  QByteArray copiedNodes() const;
 
   VoidResult loadFromSave(const QVector<std::shared_ptr<NodeSaveInfo>>& nodes, NodeItem* parent);
 };
@@ -0,0 +1,344 @@
+#include "canvas_commands.h"
+
+#include <QDataStream>
+#include <algorithm>
+
+#include "canvas.h"
+#include "elements/node.h"
+#include "elements/save_info.h"
+#include "logging.h"
+
+CanvasCommand::CanvasCommand(Canvas* canvas)
+    : mCanvas(canvas)
+{
+}
+
+NodeItem* CanvasCommand::findNode(const QString& nodeId) const
+{
+  auto node = mCanvas->findNodeWithId(nodeId);
+  if (!node)
+    LOG_WARNING("Node %s is no longer in the canvas", qPrintable(nodeId));
+
+  return node;
+}
+
+// ==========================================================================================
+// Items
+ItemsCommand::ItemsCommand(Canvas* canvas, const QStringList& nodeIds, const QStringList& transitionIds)
+    : CanvasCommand(canvas)
+    , mNodeIds(nodeIds)
+    , mTransitionIds(transitionIds)
+{
+}
+
+qsizetype ItemsCommand::cost() const
+{
+  qsizetype ids = 0;
+  for (const auto& id : mNodeIds + mTransitionIds)
+    ids += id.size() * sizeof(QChar);
+
+  return sizeof(*this) + ids + mSnapshot.size();
+}
+
+void ItemsCommand::add()
+{
+  mCanvas->restoreItems(mSnapshot);
+  mSnapshot.clear();
+}
+
+void ItemsCommand::remove()
+{
+  mSnapshot = mCanvas->snapshotItems(mNodeIds, mTransitionIds);
+  mCanvas->removeItems(mNodeIds, mTransitionIds);
+}
+
+void AddItemsCommand::undo()
+{
+  remove();
+}
+
+void AddItemsCommand::redo()
+{
+  add();
+}
+
+void RemoveItemsCommand::undo()
+{
+  add();
+}
+
+void RemoveItemsCommand::redo()
+{
+  remove();
+}
+
+// ==========================================================================================
+// Move
+MoveNodesCommand::MoveNodesCommand(Canvas* canvas, const QVector<Move>& moves)
+    : CanvasCommand(canvas)
+    , mMoves(moves)
+{
+}
+
+void MoveNodesCommand::undo()
+{
+  for (const auto& move : mMoves)
+  {
+    auto node = findNode(move.nodeId);
+    if (node)
+      node->setPos(move.from);
+  }
+}
+
+void MoveNodesCommand::redo()
+{
+  for (const auto& move : mMoves)
+  {
+    auto node = findNode(move.nodeId);
+    if (node)
+      node->setPos(move.to);
+  }
+}
+
+int MoveNodesCommand::id() const
+{
+  return MOVE_NODES;
+}
+
+bool MoveNodesCommand::mergeWith(const Command* other)
+{
+  // Only drags of the same selection are merged
+  auto next = static_cast<const MoveNodesCommand*>(other);
+  if (next->mMoves.size() != mMoves.size())
+    return false;
+
+  QVector<Move> merged = mMoves;
+  for (auto& move : merged)
+  {
+    auto found = std::find_if(next->mMoves.cbegin(), next->mMoves.cend(), [&move](const Move& nextMove) {
+      return nextMove.nodeId == move.nodeId;
+    });
+
+    if (found == next->mMoves.cend())
+      return false;
+
+    move.to = found->to;
+  }
+
+  mMoves = merged;
+  return true;
+}
+
+qsizetype MoveNodesCommand::cost() const
+{
+  qsizetype size = sizeof(*this);
+  for (const auto& move : mMoves)
+    size += sizeof(Move) + move.nodeId.size() * sizeof(QChar);
+
+  return size;
+}
+
+// ==========================================================================================
+// Resize
+ResizeNodeCommand::ResizeNodeCommand(Canvas* canvas, const QString& nodeId, const QSizeF& fromSize, qreal fromScale, const QSizeF& toSize, qreal toScale)
+    : CanvasCommand(canvas)
+    , mNodeId(nodeId)
+    , mFromSize(fromSize)
+    , mFromScale(fromScale)
+    , mToSize(toSize)
+    , mToScale(toScale)
+{
+}
+
+void ResizeNodeCommand::undo()
+{
+  auto node = findNode(mNodeId);
+  if (node)
+    node->resize(mFromSize, mFromScale);
+}
+
+void ResizeNodeCommand::redo()
+{
+  auto node = findNode(mNodeId);
+  if (node)
+    node->resize(mToSize, mToScale);
+}
+
+int ResizeNodeCommand::id() const
+{
+  return RESIZE_NODE;
+}
+
+bool ResizeNodeCommand::mergeWith(const Command* other)
+{
+  auto next = static_cast<const ResizeNodeCommand*>(other);
+  if (next->mNodeId != mNodeId)
+    return false;
+
+  mToSize = next->mToSize;
+  mToScale = next->mToScale;
+  return true;
+}
+
+// ==========================================================================================
+// Properties
+SetPropertyCommand::SetPropertyCommand(Canvas* canvas, const QString& nodeId, const QString& key, const QVariant& from, const QVariant& to)
+    : CanvasCommand(canvas)
+    , mNodeId(nodeId)
+    , mKey(key)
+    , mFrom(from)
+    , mTo(to)
+{
+}
+
+void SetPropertyCommand::undo()
+{
+  auto node = findNode(mNodeId);
+  if (node)
+    node->setProperty(mKey, mFrom);
+}
+
+void SetPropertyCommand::redo()
+{
+  auto node = findNode(mNodeId);
+  if (node)
+    node->setProperty(mKey, mTo);
+}
+
+int SetPropertyCommand::id() const
+{
+  return SET_PROPERTY;
+}
+
+bool SetPropertyCommand::mergeWith(const Command* other)
+{
+  // Typing in a property sends one change per keystroke
+  auto next = static_cast<const SetPropertyCommand*>(other);
+  if (next->mNodeId != mNodeId || next->mKey != mKey)
+    return false;
+
+  mTo = next->mTo;
+  return true;
+}
+
+qsizetype SetPropertyCommand::cost() const
+{
+  auto valueSize = [](const QVariant& value) -> qsizetype {
+    if (value.typeId() == QMetaType::QString)
+      return value.toString().size() * sizeof(QChar);
+
+    return sizeof(QVariant);
+  };
+
+  return sizeof(*this) + (mNodeId.size() + mKey.size()) * sizeof(QChar) + valueSize(mFrom) + valueSize(mTo);
+}
+
+SetFieldCommand::SetFieldCommand(Canvas* canvas, const QString& nodeId, const QString& key, const std::optional<PropertiesConfig>& from, const std::optional<PropertiesConfig>& to)
+    : CanvasCommand(canvas)
+    , mNodeId(nodeId)
+    , mKey(key)
+    , mFrom(from)
+    , mTo(to)
+{
+}
+
+void SetFieldCommand::undo()
+{
+  apply(mFrom);
+}
+
+void SetFieldCommand::redo()
+{
+  apply(mTo);
+}
+
+void SetFieldCommand::apply(const std::optional<PropertiesConfig>& value)
+{
+  auto node = findNode(mNodeId);
+  if (!node)
+    return;
+
+  if (value)
+  {
+    LOG_WARN_ON_FAILURE(node->setField(mKey, *value));
+  }
+  else
+  {
+    node->removeField(mKey);
+  }
+}
+
+int SetFieldCommand::id() const
+{
+  return SET_FIELD;
+}
+
+bool SetFieldCommand::mergeWith(const Command* other)
+{
+  auto next = static_cast<const SetFieldCommand*>(other);
+  if (next->mNodeId != mNodeId || next->mKey != mKey)
+    return false;
+
+  mTo = next->mTo;
+  return true;
+}
+
+qsizetype SetFieldCommand::cost() const
+{
+  return sizeof(*this) + (mNodeId.size() + mKey.size()) * sizeof(QChar) + 2 * sizeof(PropertiesConfig);
+}
+
+// ==========================================================================================
+// Flows
+FlowCommand::FlowCommand(Canvas* canvas, const QString& nodeId, std::shared_ptr<FlowSaveInfo> flow, bool added)
+    : CanvasCommand(canvas)
+    , mNodeId(nodeId)
+    , mAdded(added)
+    , mFlow(flow)
+    , mEncodedSize(0)
+{
+  // Measured like the snapshots of ItemsCommand, the nodes own strings and maps
+  // that sizeof does not see
+  QByteArray encoded;
+  QDataStream stream(&encoded, QIODevice::WriteOnly);
+  stream << *mFlow;
+  mEncodedSize = encoded.size();
+}
+
+void FlowCommand::undo()
+{
+  if (mAdded)
+    remove();
+  else
+    add();
+}
+
+void FlowCommand::redo()
+{
+  if (mAdded)
+    add();
+  else
+    remove();
+}
+
+qsizetype FlowCommand::cost() const
+{
+  return sizeof(*this) + mEncodedSize;
+}
+
+void FlowCommand::add()
+{
+  auto node = findNode(mNodeId);
+  if (node && !node->getFlow(mFlow->id))
+    (void)node->createFlow(mFlow->name, mFlow);
+}
+
+void FlowCommand::remove()
+{
+  auto node = findNode(mNodeId);
+  if (!node)
+    return;
+
+  node->deleteFlow(mFlow->id);
+  emit mCanvas->flowRemoved(mFlow->id, node);
+}
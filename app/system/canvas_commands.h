@@ -0,0 +1,180 @@
+#pragma once
+
+#include <QByteArray>
+#include <QPointF>
+#include <QSizeF>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <memory>
+#include <optional>
+
+#include "config.h"
+#include "undo_stack.h"
+
+class Canvas;
+class NodeItem;
+struct FlowSaveInfo;
+
+// Ids of the commands that merge with the previous one
+enum CommandIds
+{
+  MOVE_NODES = 1,
+  RESIZE_NODE,
+  SET_PROPERTY,
+  SET_FIELD
+};
+
+// Commands refer to nodes by id since the items are recreated when a deletion
+// is undone
+class CanvasCommand : public Command
+{
+public:
+  CanvasCommand(Canvas* canvas);
+
+protected:
+  Canvas* mCanvas;
+
+  NodeItem* findNode(const QString& nodeId) const;
+};
+
+// Nodes and transitions that were added or removed. While the items are in the
+// scene nothing is stored, once they are removed they are kept as a binary
+// snapshot of their save info.
+class ItemsCommand : public CanvasCommand
+{
+public:
+  ItemsCommand(Canvas* canvas, const QStringList& nodeIds, const QStringList& transitionIds);
+
+  qsizetype cost() const override;
+
+protected:
+  const QStringList mNodeIds;
+  const QStringList mTransitionIds;
+  QByteArray mSnapshot;
+
+  void add();
+  void remove();
+};
+
+class AddItemsCommand : public ItemsCommand
+{
+public:
+  using ItemsCommand::ItemsCommand;
+
+  void undo() override;
+  void redo() override;
+};
+
+class RemoveItemsCommand : public ItemsCommand
+{
+public:
+  using ItemsCommand::ItemsCommand;
+
+  void undo() override;
+  void redo() override;
+};
+
+class MoveNodesCommand : public CanvasCommand
+{
+public:
+  struct Move
+  {
+    QString nodeId;
+    QPointF from;
+    QPointF to;
+  };
+
+  MoveNodesCommand(Canvas* canvas, const QVector<Move>& moves);
+
+  void undo() override;
+  void redo() override;
+
+  int id() const override;
+  bool mergeWith(const Command* other) override;
+  qsizetype cost() const override;
+
+private:
+  QVector<Move> mMoves;
+};
+
+class ResizeNodeCommand : public CanvasCommand
+{
+public:
+  ResizeNodeCommand(Canvas* canvas, const QString& nodeId, const QSizeF& fromSize, qreal fromScale, const QSizeF& toSize, qreal toScale);
+
+  void undo() override;
+  void redo() override;
+
+  int id() const override;
+  bool mergeWith(const Command* other) override;
+
+private:
+  const QString mNodeId;
+  QSizeF mFromSize;
+  qreal mFromScale;
+  QSizeF mToSize;
+  qreal mToScale;
+};
+
+class SetPropertyCommand : public CanvasCommand
+{
+public:
+  SetPropertyCommand(Canvas* canvas, const QString& nodeId, const QString& key, const QVariant& from, const QVariant& to);
+
+  void undo() override;
+  void redo() override;
+
+  int id() const override;
+  bool mergeWith(const Command* other) override;
+  qsizetype cost() const override;
+
+private:
+  const QString mNodeId;
+  const QString mKey;
+  QVariant mFrom;
+  QVariant mTo;
+};
+
+// A missing value means that the field did not exist
+class SetFieldCommand : public CanvasCommand
+{
+public:
+  SetFieldCommand(Canvas* canvas, const QString& nodeId, const QString& key, const std::optional<PropertiesConfig>& from, const std::optional<PropertiesConfig>& to);
+
+  void undo() override;
+  void redo() override;
+
+  int id() const override;
+  bool mergeWith(const Command* other) override;
+  qsizetype cost() const override;
+
+private:
+  const QString mNodeId;
+  const QString mKey;
+  std::optional<PropertiesConfig> mFrom;
+  std::optional<PropertiesConfig> mTo;
+
+  void apply(const std::optional<PropertiesConfig>& value);
+};
+
+class FlowCommand : public CanvasCommand
+{
+public:
+  FlowCommand(Canvas* canvas, const QString& nodeId, std::shared_ptr<FlowSaveInfo> flow, bool added);
+
+  void undo() override;
+  void redo() override;
+
+  qsizetype cost() const override;
+
+private:
+  const QString mNodeId;
+  const bool mAdded;
+  std::shared_ptr<FlowSaveInfo> mFlow;
+  qsizetype mEncodedSize;
+
+  void add();
+  void remove();
+};
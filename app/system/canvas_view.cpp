@@ -2,14 +2,18 @@
 
 #include <qgraphicsview.h>
 
+#include <QRubberBand>
 #include <QShortcut>
 
 #include "app_configs.h"
 #include "canvas.h"
 
 static constexpr qreal DEFAULT_ZOOM = 1.0;
+// Enough to fill a large screen at the minimum zoom
+static constexpr qreal PAN_MARGIN = 50000.0;
 
 CanvasView::CanvasView(QWidget* parent)
+    : mRubberBand(nullptr)
 {
   setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
   setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
@@ -23,7 +27,7 @@ CanvasView::CanvasView(QWidget* parent)
   setDragMode(QGraphicsView::RubberBandDrag);
   setAcceptDrops(true);
 
-  setMaxSize();
+  setPanArea(QRectF());
   centerOn({0, 0});
 
   // TODO(felaze): make these configurable
@@ -60,6 +64,21 @@ void CanvasView::centerOn(const QPointF& pos)
   QGraphicsView::centerOn(mCenterPoint);
 }
 
+void CanvasView::showRubberBand(const QRectF& sceneRect)
+{
+  if (!mRubberBand)
+    mRubberBand = new QRubberBand(QRubberBand::Rectangle, viewport());
+
+  mRubberBand->setGeometry(mapFromScene(sceneRect).boundingRect().normalized());
+  mRubberBand->show();
+}
+
+void CanvasView::hideRubberBand()
+{
+  if (mRubberBand)
+    mRubberBand->hide();
+}
+
 void CanvasView::setScale(qreal scale)
 {
   QTransform t;
@@ -69,9 +88,9 @@ void CanvasView::setScale(qreal scale)
   update();
 }
 
-void CanvasView::setMaxSize()
+void CanvasView::setPanArea(const QRectF& area)
 {
-  setSceneRect(INT_MIN / 2, INT_MIN / 2, INT_MAX, INT_MAX);
+  setSceneRect(area.adjusted(-PAN_MARGIN, -PAN_MARGIN, PAN_MARGIN, PAN_MARGIN));
 }
 
 void CanvasView::keyPressEvent(QKeyEvent* event)
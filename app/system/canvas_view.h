@@ -5,6 +5,7 @@
 #include <QWheelEvent>
 
 class Canvas;
+class QRubberBand;
 
 class CanvasView : public QGraphicsView
 {
@@ -21,6 +22,13 @@ public:
   void centerOn(const QPointF& pos);
   void centerOn(const QGraphicsItem* item);
 
+  // The canvas does its own rubber band selection, the view only draws it
+  void showRubberBand(const QRectF& sceneRect);
+  void hideRubberBand();
+
+  // Lets the view pan a fixed distance past the area the canvas occupies
+  void setPanArea(const QRectF& area);
+
 protected:
   void keyPressEvent(QKeyEvent*) override;
   void keyReleaseEvent(QKeyEvent*) override;
@@ -47,12 +55,12 @@ private:
   qreal mMaxZoom;
   Qt::MouseButton mPanButton;
 
+  QRubberBand* mRubberBand;
+
   void pan(QPointF delta);
 
   void zoomIn();
   void zoomOut();
   void resetZoom();
   qreal quantisedScale(qreal proposedScale) const;
-
-  void setMaxSize();
 };
@@ -5,20 +5,34 @@ ConfigurationTable::ConfigurationTable()
 {
 }
 
-VoidResult ConfigurationTable::add(const QString& key, std::shared_ptr<NodeConfig> value)
+VoidResult ConfigurationTable::add(Symbol key, std::shared_ptr<NodeConfig> value)
 {
-  if (mMap.find(key) != mMap.end())
+  if (!key.isValid())
+    return VoidResult::Failed("Invalid key");
+
+  if (mMap.contains(key))
     return VoidResult::Failed("Key already exists");
 
-  mMap.insert({key, value});
+  value->key = key;
+  value->buildDefaults();
+  mMap.insert(key, value);
 
   return VoidResult();
 }
 
+std::shared_ptr<NodeConfig> ConfigurationTable::get(Symbol key) const
+{
+  return mMap.value(key, nullptr);
+}
+
 std::shared_ptr<NodeConfig> ConfigurationTable::get(const QString& key) const
 {
-  if (mMap.find(key) == mMap.end())
-    return nullptr;
+  // Unknown names are never added to the table. Slower than a handle, only for
+  // names that come from outside, e.g. the palette
+  return get(Symbol::find(key));
+}
 
-  return mMap.at(key);
+QList<Symbol> ConfigurationTable::keys() const
+{
+  return mMap.keys();
 }
@@ -1,19 +1,23 @@
 #pragma once
 
+#include <QHash>
 #include <QString>
-#include <map>
 
 #include "config.h"
 #include "result.h"
+#include "symbol.h"
 
 class ConfigurationTable
 {
 public:
   ConfigurationTable();
 
-  VoidResult add(const QString& key, std::shared_ptr<NodeConfig> value);
+  VoidResult add(Symbol key, std::shared_ptr<NodeConfig> value);
+  std::shared_ptr<NodeConfig> get(Symbol key) const;
   std::shared_ptr<NodeConfig> get(const QString& key) const;
 
+  QList<Symbol> keys() const;
+
 private:
-  std::map<QString, std::shared_ptr<NodeConfig>> mMap;
+  QHash<Symbol, std::shared_ptr<NodeConfig>> mMap;
 };
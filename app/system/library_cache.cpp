@@ -0,0 +1,232 @@
+#include "library_cache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "app_configs.h"
+#include "logging.h"
+#include "style_helpers.h"
+
+static const quint32 CACHE_MAGIC = 0x4D414B4C;  // MAKL
+// Bump whenever the layout of the cache or of the configs changes
+static const quint32 CACHE_FORMAT = 1;
+
+Result<QVector<LibraryInfo>> LibraryCache::load(const QString& fileName)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  QFile file(fileName);
+  if (!file.open(QFile::ReadOnly))
+    return Result<QVector<LibraryInfo>>::Failed("Failed to open configuration: " + fileName.toStdString());
+
+  const QByteArray data = file.readAll();
+  file.close();
+
+  // The resource is compiled into the binary, hashing it is far cheaper than parsing it
+  QCryptographicHash hasher(QCryptographicHash::Sha1);
+  hasher.addData(data);
+  hasher.addData(Config::VERSION.toUtf8());
+  const QByteArray hash = hasher.result();
+
+  const QString path = cachePath(fileName);
+  auto cached = read(path, hash);
+  if (cached.IsSuccess())
+  {
+    LOG_DEBUG("Library %s read from the cache in %lld ms", qPrintable(fileName), timer.elapsed());
+    return cached;
+  }
+
+  LOG_DEBUG("Library cache for %s not used: %s", qPrintable(fileName), cached.ErrorMessage().c_str());
+
+  auto parsed = parse(data);
+  if (!parsed.IsSuccess())
+    return parsed;
+
+  // Failing to write the cache only costs the next startup
+  LOG_WARN_ON_FAILURE(write(path, hash, parsed.Value()));
+
+  LOG_DEBUG("Library %s parsed in %lld ms", qPrintable(fileName), timer.elapsed());
+
+  return parsed;
+}
+
+QString LibraryCache::cachePath(const QString& fileName)
+{
+  // Packs in different folders may share a file name
+  const QByteArray location = QCryptographicHash::hash(QFileInfo(fileName).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex().left(8);
+
+  const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  return QDir(dir).filePath(QStringLiteral("libraries/%1-%2.bin").arg(QFileInfo(fileName).completeBaseName(), QString::fromLatin1(location)));
+}
+
+QStringList LibraryCache::searchPaths()
+{
+  // e.g. ~/.config/MakiEditor/libraries
+  const QString userDir = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/libraries";
+
+  // Ensure user dir exists so users know where to drop files
+  QDir().mkpath(userDir);
+
+  return {getDirPathFor("share/libraries"), userDir};
+}
+
+QStringList LibraryCache::externalLibraries()
+{
+  QStringList files;
+  for (const QString& dirPath : searchPaths())
+  {
+    QDir dir(dirPath);
+    if (!dir.exists())
+      continue;
+
+    for (const QFileInfo& fi : dir.entryInfoList(QStringList() << "*.json", QDir::Files, QDir::Name))
+      files.push_back(fi.absoluteFilePath());
+  }
+
+  return files;
+}
+
+Result<QVector<LibraryInfo>> LibraryCache::parse(const QByteArray& data)
+{
+  QJsonParseError error;
+  QJsonDocument document = QJsonDocument::fromJson(data, &error);
+  if (document.isNull())
+    return Result<QVector<LibraryInfo>>::Failed("Invalid library: " + error.errorString().toStdString());
+
+  QJsonObject config = document.object();
+  if (!config.contains("name"))
+    return Result<QVector<LibraryInfo>>::Failed("Packages must have a name");
+
+  if (!config.contains("libraries"))
+    return Result<QVector<LibraryInfo>>::Failed("Packages must have libraries");
+
+  QVector<LibraryInfo> libraries;
+
+  QString name = config["name"].toString();
+  for (const auto& value : config["libraries"].toArray())
+  {
+    if (!value.isObject())
+      return Result<QVector<LibraryInfo>>::Failed("Invalid library format");
+
+    QJsonObject library = value.toObject();
+    if (!library.contains("type"))
+      return Result<QVector<LibraryInfo>>::Failed("Libraries must have a type");
+
+    auto nodes = library["nodes"];
+    if (!nodes.isArray())
+      return Result<QVector<LibraryInfo>>::Failed("nodes must be in a list in the format \"nodes\": []");
+
+    LibraryInfo info;
+    info.name = name;
+    info.type = library["type"].toString();
+
+    for (const auto& node : nodes.toArray())
+    {
+      if (!node.isObject())
+        return Result<QVector<LibraryInfo>>::Failed("Invalid node format");
+
+      // Parse config and make sure it is valid before continuing
+      auto nodeConfig = std::make_shared<NodeConfig>(node.toObject());
+      if (!nodeConfig->isValid())
+        return Result<QVector<LibraryInfo>>::Failed(nodeConfig->errorMessage.toStdString());
+
+      // Initialize the library type
+      if (info.type == "structure")
+        nodeConfig->libraryType = Types::LibraryTypes::STRUCTURAL;
+      else
+        nodeConfig->libraryType = Types::LibraryTypes::BEHAVIOUR;
+
+      info.nodes.push_back(nodeConfig);
+    }
+
+    libraries.push_back(info);
+  }
+
+  return Result<QVector<LibraryInfo>>(libraries);
+}
+
+Result<QVector<LibraryInfo>> LibraryCache::read(const QString& path, const QByteArray& hash)
+{
+  QFile file(path);
+  if (!file.open(QFile::ReadOnly))
+    return Result<QVector<LibraryInfo>>::Failed("no cache");
+
+  // Map the file instead of copying it, the stream reads straight from the pages
+  uchar* mapped = file.map(0, file.size());
+  QByteArray data = mapped ? QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file.size()) : file.readAll();
+
+  QDataStream in(data);
+  in.setVersion(QDataStream::Qt_6_0);
+
+  quint32 magic = 0;
+  quint32 format = 0;
+  QByteArray cachedHash;
+  in >> magic >> format >> cachedHash;
+
+  if (magic != CACHE_MAGIC || format != CACHE_FORMAT || cachedHash != hash)
+    return Result<QVector<LibraryInfo>>::Failed("outdated cache");
+
+  quint32 count = 0;
+  in >> count;
+
+  // The counts are not trusted, so nothing is allocated up front and reading
+  // stops as soon as the stream runs out
+  QVector<LibraryInfo> libraries;
+  for (quint32 l = 0; l < count && in.status() == QDataStream::Ok; ++l)
+  {
+    LibraryInfo library;
+    quint32 nodes = 0;
+    in >> library.name >> library.type >> nodes;
+
+    for (quint32 i = 0; i < nodes && in.status() == QDataStream::Ok; ++i)
+    {
+      auto config = std::make_shared<NodeConfig>();
+      in >> *config;
+      library.nodes.push_back(config);
+    }
+
+    libraries.push_back(library);
+  }
+
+  if (in.status() != QDataStream::Ok)
+    return Result<QVector<LibraryInfo>>::Failed("corrupted cache");
+
+  return Result<QVector<LibraryInfo>>(libraries);
+}
+
+VoidResult LibraryCache::write(const QString& path, const QByteArray& hash, const QVector<LibraryInfo>& libraries)
+{
+  if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+    return VoidResult::Failed("Could not create the cache directory for " + path.toStdString());
+
+  // Written to a temporary file first so a crash never leaves half a cache behind
+  QSaveFile file(path);
+  if (!file.open(QFile::WriteOnly))
+    return VoidResult::Failed("Could not open cache for writing: " + file.errorString().toStdString());
+
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_6_0);
+
+  out << CACHE_MAGIC << CACHE_FORMAT << hash;
+  out << quint32(libraries.size());
+  for (const auto& library : libraries)
+  {
+    out << library.name << library.type << quint32(library.nodes.size());
+    for (const auto& config : library.nodes)
+      out << *config;
+  }
+
+  if (!file.commit())
+    return VoidResult::Failed("Could not write cache: " + file.errorString().toStdString());
+
+  return VoidResult();
+}
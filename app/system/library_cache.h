@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+#include "config.h"
+#include "result.h"
+
+// One group of nodes in the sidebar
+struct LibraryInfo
+{
+  QString name;
+  QString type;
+  QVector<std::shared_ptr<NodeConfig>> nodes;
+};
+
+// The library files are only parsed and validated the first time they are seen.
+// The resulting configs are then stored in a binary file next to the other
+// caches and read back in one go on the following launches. The cache is keyed
+// by the contents of the library file and the application version, so editing
+// either one regenerates it.
+class LibraryCache
+{
+public:
+  // Safe to call from several threads at once, as long as the files differ
+  static Result<QVector<LibraryInfo>> load(const QString& fileName);
+
+  // Library packs installed next to the application and by the user, in that order
+  static QStringList searchPaths();
+  static QStringList externalLibraries();
+
+private:
+  static QString cachePath(const QString& fileName);
+
+  static Result<QVector<LibraryInfo>> parse(const QByteArray& data);
+  static Result<QVector<LibraryInfo>> read(const QString& path, const QByteArray& hash);
+  static VoidResult write(const QString& path, const QByteArray& hash, const QVector<LibraryInfo>& libraries);
+};
@@ -51,19 +51,51 @@ void LibraryContainer::updateSceneSize()
 
 VoidResult LibraryContainer::addNode(const QString& id, std::shared_ptr<NodeConfig> config)
 {
-  // Create Draggable Items
-  DraggableItem* item = new DraggableItem(id, config);
+  return addNodes({{id, config}});
+}
+
+VoidResult LibraryContainer::addNodes(const QVector<std::pair<QString, std::shared_ptr<NodeConfig>>>& nodes)
+{
+  mPending += nodes;
 
-  // Center the item in the sidebar and make sure it is below the last item added
-  item->setPos(static_cast<int>(viewport()->width() / 2), mLastItemY + PADDING);
-  mLastItemY = item->mapToScene(item->boundingRect().bottomLeft()).y();
+  // Pages that are already open get their items right away
+  if (isVisible())
+    createItems();
 
-  // Add item to scene
-  scene()->addItem(item);
+  return VoidResult();
+}
 
+void LibraryContainer::createItems()
+{
+  if (mPending.isEmpty())
+    return;
+
+  int center = static_cast<int>(viewport()->width() / 2);
+
+  for (const auto& [id, config] : mPending)
+  {
+    // Create Draggable Items
+    DraggableItem* item = new DraggableItem(id, config);
+
+    // Center the item in the sidebar and make sure it is below the last item added
+    item->setPos(center, mLastItemY + PADDING);
+    mLastItemY = item->mapToScene(item->boundingRect().bottomLeft()).y();
+
+    // Add item to scene
+    scene()->addItem(item);
+  }
+
+  mPending.clear();
+
+  // The bounding rect goes over every item, so it is only computed once
   updateSceneSize();
+  adjustNodePositions();
+}
 
-  return VoidResult();
+void LibraryContainer::showEvent(QShowEvent* event)
+{
+  createItems();
+  QGraphicsView::showEvent(event);
 }
 
 void LibraryContainer::resizeEvent(QResizeEvent* event)
@@ -13,13 +13,20 @@ public:
 
   static LibraryContainer* create(const QString& name, QToolBox* parent);
 
+  // Nodes are only kept as configs until the page is first shown, most pages
+  // are never opened in a session
   VoidResult addNode(const QString& id, std::shared_ptr<NodeConfig> config);
+  VoidResult addNodes(const QVector<std::pair<QString, std::shared_ptr<NodeConfig>>>& nodes);
 
 protected:
   void resizeEvent(QResizeEvent* event) override;
+  void showEvent(QShowEvent* event) override;
 
 private:
   int mLastItemY;
+  QVector<std::pair<QString, std::shared_ptr<NodeConfig>>> mPending;
+
+  void createItems();
 
   void updateSceneSize();
   void adjustNodePositions();
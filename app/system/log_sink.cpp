@@ -0,0 +1,151 @@
+#include "log_sink.h"
+
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextBrowser>
+#include <QTextCursor>
+#include <QTimer>
+
+#include "string_helpers.h"
+#include "style_helpers.h"
+
+// Lines kept by every panel
+static const int MAX_LINES = 1000;
+// Messages appended per tick, the rest waits for the next one
+static const int MAX_BATCH = 500;
+// Messages waiting to be shown before new ones are dropped
+static const int MAX_PENDING = 10000;
+static const int DRAIN_INTERVAL_MS = 50;
+
+LogSink::LogSink(QObject* parent)
+    : QObject(parent)
+    , mHead(new Node)
+    , mPending(0)
+    , mDropped(0)
+    , mLevel(static_cast<int>(logging::LogLevel::Debugging))
+    , mTimer(new QTimer(this))
+{
+  mTail = mHead.load();
+
+  connect(mTimer, &QTimer::timeout, this, &LogSink::drain);
+  mTimer->start(DRAIN_INTERVAL_MS);
+}
+
+LogSink::~LogSink()
+{
+  while (mTail)
+  {
+    Node* next = mTail->next.load();
+    delete mTail;
+    mTail = next;
+  }
+}
+
+void LogSink::addPanel(QTextBrowser* panel, std::optional<logging::LogLevel> onlyLevel)
+{
+  if (!panel)
+    return;
+
+  panel->document()->setMaximumBlockCount(MAX_LINES);
+  mPanels.push_back({panel, onlyLevel});
+}
+
+void LogSink::setLevel(logging::LogLevel level)
+{
+  mLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool LogSink::accepts(logging::LogLevel level) const
+{
+  return static_cast<int>(level) <= mLevel.load(std::memory_order_relaxed);
+}
+
+void LogSink::push(std::chrono::system_clock::time_point ts, logging::LogLevel level, const std::string& message)
+{
+  if (!accepts(level))
+    return;
+
+  if (mPending.fetch_add(1, std::memory_order_relaxed) >= MAX_PENDING)
+  {
+    mPending.fetch_sub(1, std::memory_order_relaxed);
+    mDropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  Node* node = new Node;
+  node->message = {ts, level, message};
+
+  Node* previous = mHead.exchange(node, std::memory_order_acq_rel);
+  previous->next.store(node, std::memory_order_release);
+}
+
+std::optional<LogSink::Message> LogSink::pop()
+{
+  Node* next = mTail->next.load(std::memory_order_acquire);
+  if (!next)
+    return std::nullopt;
+
+  // The next node becomes the new empty tail once its message is taken
+  delete mTail;
+  mTail = next;
+
+  mPending.fetch_sub(1, std::memory_order_relaxed);
+  return std::move(next->message);
+}
+
+void LogSink::drain()
+{
+  QVector<QStringList> lines(mPanels.size());
+
+  int dropped = mDropped.exchange(0, std::memory_order_relaxed);
+  for (int count = 0; count < MAX_BATCH; ++count)
+  {
+    auto message = pop();
+    if (!message)
+      break;
+
+    QString line = toQT(message->ts, message->level, message->text);
+    for (int i = 0; i < mPanels.size(); ++i)
+    {
+      if (!mPanels[i].onlyLevel || *mPanels[i].onlyLevel == message->level)
+        lines[i].push_back(line);
+    }
+  }
+
+  if (dropped > 0)
+  {
+    QString line = toQT(std::chrono::system_clock::now(), logging::LogLevel::Warning, Format("%d log messages were dropped", dropped));
+    for (int i = 0; i < mPanels.size(); ++i)
+    {
+      if (!mPanels[i].onlyLevel || *mPanels[i].onlyLevel == logging::LogLevel::Warning)
+        lines[i].push_back(line);
+    }
+  }
+
+  for (int i = 0; i < mPanels.size(); ++i)
+  {
+    if (lines[i].isEmpty())
+      continue;
+
+    QTextBrowser* view = mPanels[i].view;
+    QScrollBar* scrollBar = view->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+    // One edit block per panel, the layout is only updated once per batch
+    QTextCursor cursor(view->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    for (const QString& line : lines[i])
+    {
+      if (!view->document()->isEmpty())
+        cursor.insertBlock(QTextBlockFormat(), QTextCharFormat());
+
+      cursor.insertHtml(line);
+    }
+    cursor.endEditBlock();
+
+    // Only follow the output if the user was not scrolled up
+    if (atBottom)
+      scrollBar->setValue(scrollBar->maximum());
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+
+#include "logging.h"
+
+class QTextBrowser;
+class QTimer;
+
+// Receives the log messages from any thread and shows them in the log panels.
+// Messages are pushed to a lock free queue and a timer on the GUI thread
+// appends them in batches, so logging never waits on the UI.
+class LogSink : public QObject
+{
+  Q_OBJECT
+public:
+  LogSink(QObject* parent = nullptr);
+  ~LogSink();
+
+  // Panels keep a fixed number of lines, the oldest ones are dropped first
+  void addPanel(QTextBrowser* panel, std::optional<logging::LogLevel> onlyLevel = std::nullopt);
+
+  void setLevel(logging::LogLevel level);
+  bool accepts(logging::LogLevel level) const;
+
+  // Safe to call from any thread
+  void push(std::chrono::system_clock::time_point ts, logging::LogLevel level, const std::string& message);
+
+private:
+  struct Message
+  {
+    std::chrono::system_clock::time_point ts;
+    logging::LogLevel level;
+    std::string text;
+  };
+
+  // Multiple producers, single consumer queue. Producers only swap the head,
+  // the GUI thread owns the tail. The tail is always a node that was already
+  // read, starting with an empty one.
+  struct Node
+  {
+    std::atomic<Node*> next = nullptr;
+    Message message;
+  };
+
+  struct Panel
+  {
+    QTextBrowser* view;
+    std::optional<logging::LogLevel> onlyLevel;
+  };
+
+  std::atomic<Node*> mHead;
+  Node* mTail;
+
+  // Once the GUI falls this far behind new messages are only counted
+  std::atomic<int> mPending;
+  std::atomic<int> mDropped;
+  std::atomic<int> mLevel;
+
+  QVector<Panel> mPanels;
+  QTimer* mTimer;
+
+  void drain();
+  std::optional<Message> pop();
+};
@@ -4,7 +4,9 @@
 #include <qnamespace.h>
 
 #include <QComboBox>
+#include <QCursor>
 #include <QDrag>
+#include <QElapsedTimer>
 #include <QInputDialog>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -12,31 +14,40 @@
 #include <QPushButton>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
+#include <QSet>
 #include <QShortcut>
 #include <QString>
-#include <QTextBlock>
 #include <QTextBrowser>
+#include <QThreadPool>
 #include <QWidget>
+#include <optional>
 
 #include "app_configs.h"
 #include "behaviour_canvas.h"
 #include "canvas.h"
 #include "canvas_view.h"
+#include "elements/draggable.h"
 #include "elements/flow.h"
 #include "elements/node.h"
+#include "library_cache.h"
 #include "library_container.h"
+#include "log_sink.h"
 #include "logging.h"
 #include "plugin_manager.h"
 #include "process_tab.h"
 #include "save_handler.h"
 #include "structure_canvas.h"
 #include "style_helpers.h"
+#include "symbol.h"
+#include "verification_scheduler.h"
+#include "widgets/node_palette.h"
 #include "widgets/properties/fields_menu.h"
 #include "widgets/properties/properties_menu.h"
 #include "widgets/settings_dialog.h"
 #include "widgets/settings_manager.h"
 #include "widgets/structure/flow_menu.h"
 #include "widgets/structure/system_menu.h"
+#include "widgets/verification_panel.h"
 
 MainWindow::MainWindow(QApplication* app, QWidget* parent)
     : MainWindowlayout(parent)
@@ -47,22 +58,27 @@ MainWindow::MainWindow(QApplication* app, QWidget* parent)
 
 MainWindow::~MainWindow()
 {
+  // The sink goes away with the window, so anything that may still log from
+  // another thread or while being torn down has to be gone before the hook is
+  QThreadPool::globalInstance()->waitForDone();
+  delete mVerificationScheduler;
+  mVerificationScheduler = nullptr;
+
+  logging::gLogToStream = nullptr;
 }
 
 VoidResult MainWindow::start()
 {
-  mLogLevel = logging::LogLevel::Debugging;
-
-  logging::gLogToStream = [this](std::chrono::system_clock::time_point ts, logging::LogLevel level, const std::string& filename, const uint32_t& line, const std::string& message) {
-    if (level > mLogLevel)
-      return;
-
-    QString logMessage = toQT(ts, level, message);
-    handleLogging(logMessage, mLogText);
-    if (level == logging::LogLevel::Error)
-      handleLogging(logMessage, mErrorLogText);
-    if (level == logging::LogLevel::Warning)
-      handleLogging(logMessage, mWarningLogText);
+  mLogSink = new LogSink(this);
+  mLogSink->addPanel(mLogText);
+  mLogSink->addPanel(mErrorLogText, logging::LogLevel::Error);
+  mLogSink->addPanel(mWarningLogText, logging::LogLevel::Warning);
+
+  // Called from whatever thread logs, the sink hands the message to the GUI thread.
+  // Filtered levels return before the message is copied or turned into html.
+  logging::gLogToStream = [sink = mLogSink](std::chrono::system_clock::time_point ts, logging::LogLevel level, const std::string& filename, const uint32_t& line, const std::string& message) {
+    if (sink->accepts(level))
+      sink->push(ts, level, message);
   };
 
   auto configRead = JSON::fromFile(":/assets/config.json");
@@ -85,9 +101,17 @@ VoidResult MainWindow::start()
   bindShortcuts();
 
   mPropertiesMenu->start(mStorage);
+  mSystemMenu->start(mStorage);
+
+  mVerificationScheduler = new VerificationScheduler(this);
+  mBottomPanel->addTab(new VerificationPanel(mVerificationScheduler, mBottomPanel), tr("Verification"));
 
   RETURN_ON_FAILURE(loadElements());
 
+  mNodePalette = new NodePalette(this);
+  mNodePalette->buildIndex(mConfigTable);
+  connect(mNodePalette, &NodePalette::nodeSelected, this, &MainWindow::addNodeFromPalette);
+
   // Set initial tabs
   mLeftPanel->setCurrentIndex(0);
   mNavigationTab->setCurrentIndex(0);
@@ -97,6 +121,9 @@ VoidResult MainWindow::start()
   {
     onThemeChanged(mSettingsManager->appearance().theme, mSettingsManager->availableThemes());
     connect(mSettingsManager.get(), &SettingsManager::themeChanged, this, &MainWindow::onThemeChanged);
+
+    onGeneralSettingsChanged(mSettingsManager->general());
+    connect(mSettingsManager.get(), &SettingsManager::generalChanged, this, &MainWindow::onGeneralSettingsChanged);
   }
 
   LOG_DEBUG("Main window started");
@@ -104,6 +131,13 @@ VoidResult MainWindow::start()
   return VoidResult();
 }
 
+void MainWindow::onGeneralSettingsChanged(const GeneralSettings& settings)
+{
+  // The combo box can still be changed by hand afterwards
+  auto level = settings.enableDebugLogs ? logging::LogLevel::Debugging : logging::LogLevel::Info;
+  mLogLevelComboBox->setCurrentIndex(mLogLevelComboBox->findData(static_cast<int>(level)));
+}
+
 void MainWindow::onThemeChanged(const QString& t, const QList<Config::ThemeInfo>& at)
 {
   Config::applyThemeToApp(mApp, t, at);
@@ -178,6 +212,10 @@ void MainWindow::bind()
   connect(mFlowMenu, &FlowMenu::flowSelected, rootCanvas(), &Canvas::onFlowSelected);
   connect(mFlowMenu, &FlowMenu::flowRemoved, rootCanvas(), &Canvas::onFlowRemoved);
 
+  connect(mLogLevelComboBox, &QComboBox::currentIndexChanged, this, [this](int index) {
+    mLogSink->setLevel(static_cast<logging::LogLevel>(mLogLevelComboBox->itemData(index).toInt()));
+  });
+
   bindCanvas();
 }
 
@@ -185,6 +223,7 @@ void MainWindow::bindCanvas()
 {
   connect(canvas(), &Canvas::nodeSelected, this, &MainWindow::onNodeSelected);
   connect(canvas(), &Canvas::nodeAdded, this, &MainWindow::onNodeAdded);
+  connect(canvas(), &Canvas::nodesAdded, this, &MainWindow::onNodesAdded);
   connect(canvas(), &Canvas::nodeRemoved, this, &MainWindow::onNodeRemoved);
   connect(canvas(), &Canvas::nodeModified, this, &MainWindow::onNodeModified);
 
@@ -201,6 +240,7 @@ void MainWindow::unbindCanvas()
 {
   disconnect(canvas(), &Canvas::nodeSelected, this, &MainWindow::onNodeSelected);
   disconnect(canvas(), &Canvas::nodeAdded, this, &MainWindow::onNodeAdded);
+  disconnect(canvas(), &Canvas::nodesAdded, this, &MainWindow::onNodesAdded);
   disconnect(canvas(), &Canvas::nodeRemoved, this, &MainWindow::onNodeRemoved);
   disconnect(canvas(), &Canvas::nodeModified, this, &MainWindow::onNodeModified);
   disconnect(canvas(), &Canvas::createEvent, mPropertiesMenu, &PropertiesMenu::onCreateEvent);
@@ -225,6 +265,49 @@ void MainWindow::bindShortcuts()
     if (canvas())
       canvas()->deleteSelectedItems();
   });
+  new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Z), this, [this] {
+    if (canvas())
+      canvas()->undo();
+  });
+  new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_Z), this, [this] {
+    if (canvas())
+      canvas()->redo();
+  });
+  new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Y), this, [this] {
+    if (canvas())
+      canvas()->redo();
+  });
+  new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Space), this, [this] {
+    openNodePalette();
+  });
+}
+
+void MainWindow::openNodePalette()
+{
+  if (!canvas() || !mNodePalette)
+    return;
+
+  mPalettePosition = QCursor::pos();
+  mNodePalette->openFor(canvas()->type());
+}
+
+void MainWindow::addNodeFromPalette(const QString& nodeId)
+{
+  auto view = qobject_cast<CanvasView*>(mCanvasPanel->currentWidget());
+  auto config = mConfigTable->get(nodeId);
+  if (!canvas() || !view || !config)
+    return;
+
+  // The node goes under the cursor, or in the middle of the view if the cursor
+  // was somewhere else
+  QPoint viewPosition = view->viewport()->mapFromGlobal(mPalettePosition);
+  if (!view->viewport()->rect().contains(viewPosition))
+    viewPosition = view->viewport()->rect().center();
+
+  // Same data as dragging the node from the library
+  auto info = std::make_shared<NodeSaveInfo>(DraggableItem::dropInfo(nodeId, config));
+
+  canvas()->dropNode(info, view->mapToScene(viewPosition));
 }
 
 Canvas* MainWindow::canvas() const
@@ -249,97 +332,105 @@ VoidResult MainWindow::loadElements()
   if (!libraries.isArray())
     return VoidResult::Failed("Libraries must be in a list in the format \"libraries\": []");
 
+  // The built-in libraries come first, then the packs from the search path
+  QStringList files;
   for (const auto& library : libraries.toArray())
-  {
-    QString fileName = QStringLiteral(":/libraries/%1.json").arg(library.toString());
+    files.push_back(QStringLiteral(":/libraries/%1.json").arg(library.toString()));
 
-    auto libRead = JSON::fromFile(fileName);
-    if (!libRead.IsSuccess())
-      return VoidResult::Failed(
-          QStringLiteral("Failed to open configuration: %1")
-              .arg(fileName)
-              .toStdString());
+  const int builtinCount = files.size();
+  files += LibraryCache::externalLibraries();
 
-    auto libConfig = libRead.Value();
+  // Startup breakdown, the configs either come from the cache or the json files
+  QElapsedTimer timer;
+  timer.start();
 
-    RETURN_ON_FAILURE(loadLibrary(libConfig));
+  // Every file is parsed on its own thread, only the widgets are created here
+  std::vector<std::optional<Result<QVector<LibraryInfo>>>> loaded(files.size());
+  QThreadPool pool;
+  for (int i = 0; i < files.size(); ++i)
+  {
+    pool.start([&loaded, &files, i]() {
+      loaded[i] = LibraryCache::load(files[i]);
+    });
   }
 
-  return VoidResult();
-}
+  pool.waitForDone();
+  qint64 loadTime = timer.elapsed();
 
-VoidResult MainWindow::loadLibrary(const JSON& config)
-{
-  if (!config.contains("name"))
-    return VoidResult::Failed("Packages must have a name");
+  int nodeCount = 0;
+  for (int i = 0; i < files.size(); ++i)
+  {
+    const auto& libRead = *loaded[i];
+    if (!libRead.IsSuccess())
+    {
+      QString error = QStringLiteral("Failed to load library %1: %2").arg(files[i], QString::fromStdString(libRead.ErrorMessage()));
+      if (i < builtinCount)
+        return VoidResult::Failed(error.toStdString());
 
-  if (!config.contains("libraries"))
-    return VoidResult::Failed("Packages must have libraries");
+      // A broken pack should not keep the editor from starting
+      LOG_ERROR("%s", qPrintable(error));
+      continue;
+    }
 
-  QString name = config["name"].toString();
-  auto libraries = config["libraries"].toArray();
-  for (const auto& value : libraries)
-  {
-    if (!value.isObject())
-      return VoidResult::Failed("Invalid library format");
+    for (const auto& elementLibrary : libRead.Value())
+    {
+      auto added = loadElementLibrary(elementLibrary);
+      if (!added.IsSuccess())
+      {
+        if (i < builtinCount)
+          return added;
+
+        LOG_ERROR("Failed to load library %s: %s", qPrintable(files[i]), added.ErrorMessage().c_str());
+        continue;
+      }
 
-    QJsonObject library = value.toObject();
-    RETURN_ON_FAILURE(loadElementLibrary(name, library));
+      nodeCount += elementLibrary.nodes.size();
+    }
   }
 
+  LOG_INFO("Loaded %d nodes from %lld files in %lld ms (configs: %lld ms on %d threads, sidebar: %lld ms)",
+           nodeCount, qint64(files.size()), timer.elapsed(), loadTime, pool.maxThreadCount(), timer.elapsed() - loadTime);
+
   return VoidResult();
 }
 
-VoidResult MainWindow::loadElementLibrary(const QString& name, const JSON& config)
+VoidResult MainWindow::loadElementLibrary(const LibraryInfo& library)
 {
-  if (!config.contains("type"))
-    return VoidResult::Failed("Libraries must have a type");
+  LOG_DEBUG("Loading library: %s", qPrintable(library.name));
+
+  // Packs may define nodes that already exist, nothing is added in that case
+  QVector<std::pair<QString, std::shared_ptr<NodeConfig>>> nodes;
+  QSet<Symbol> ids;
+  nodes.reserve(library.nodes.size());
+  ids.reserve(library.nodes.size());
+  for (const auto& config : library.nodes)
+  {
+    Symbol id(QStringLiteral("%1::%2").arg(library.name, config->type));
+    if (mConfigTable->get(id))
+      return VoidResult::Failed("Node " + id.toString().toStdString() + " already exists");
 
-  QString type = config["type"].toString();
+    // Or the pack defines it twice
+    if (ids.contains(id))
+      return VoidResult::Failed("Node " + id.toString().toStdString() + " is defined more than once");
 
-  LOG_DEBUG("Loading library: %s", qPrintable(name));
+    ids.insert(id);
+    nodes.push_back({id.toString(), config});
+  }
+
+  // The ids were interned above, so finding them again does not add anything
+  for (const auto& [id, config] : nodes)
+    RETURN_ON_FAILURE(mConfigTable->add(Symbol::find(id), config));
 
   // Every library is added to a new item in the toolbox.
   // We load those dynamically on startup.
   QToolBox* toolbox = nullptr;
-  if (type == "structure")
+  if (library.type == "structure")
     toolbox = mStructureToolBox;
   else
     toolbox = mBehaviourToolBox;
 
-  LibraryContainer* sidebarview = LibraryContainer::create(name, toolbox);
-
-  auto nodes = config["nodes"];
-  if (!nodes.isArray())
-    return VoidResult::Failed(
-        "nodes must be in a list in the format \"nodes\": []");
-
-  // Every library has a bunch of elements, here we add them.
-  for (const auto& value : nodes.toArray())
-  {
-    if (!value.isObject())
-      return VoidResult::Failed("Invalid node format");
-
-    QJsonObject node = value.toObject();
-
-    // Parse config and make sure it is valid before continuing
-    auto config = std::make_shared<NodeConfig>(node);
-    if (!config->isValid())
-      return VoidResult::Failed(config->errorMessage.toStdString());
-
-    // Initialize the library type
-    if (type == "structure")
-      config->libraryType = Types::LibraryTypes::STRUCTURAL;
-    else
-      config->libraryType = Types::LibraryTypes::BEHAVIOUR;
-
-    auto id = QStringLiteral("%1::%2").arg(name, config->type);
-    sidebarview->addNode(id, config);
-
-    RETURN_ON_FAILURE(mConfigTable->add(id, config));
-  }
-
-  return VoidResult();
+  LibraryContainer* sidebarview = LibraryContainer::create(library.name, toolbox);
+  return sidebarview->addNodes(nodes);
 }
 
 void MainWindow::onActionNew()
@@ -360,7 +451,11 @@ void MainWindow::onActionGenerate()
   if (!mGenerator)
     LOG_WARNING("No generator available");
 
-  mGenerator->generate(mPluginManager->currentPlugin());
+  // Only the models written now are verified, older ones may be left in the folder
+  QStringList models = mGenerator->generate(mPluginManager->currentPlugin()).filter(QRegularExpression("\\.dzn$"));
+
+  if (!models.isEmpty() && mVerificationScheduler)
+    mVerificationScheduler->verify(models);
 }
 
 void MainWindow::onActionSave()
@@ -442,6 +537,19 @@ void MainWindow::onNodeAdded(NodeItem* node)
   }
 }
 
+void MainWindow::onNodesAdded(const QList<NodeItem*>& nodes)
+{
+  if (canvas()->type() == Types::LibraryTypes::STRUCTURAL)
+  {
+    LOG_WARN_ON_FAILURE(mSystemMenu->onNodesAdded(nodes));
+    LOG_WARN_ON_FAILURE(mPropertiesMenu->onNodesAdded(nodes));
+  }
+  else
+  {
+    LOG_WARN_ON_FAILURE(mFlowMenu->onNodesAdded(canvas()->id(), nodes));
+  }
+}
+
 void MainWindow::onNodeRemoved(NodeItem* node)
 {
   if (!node)
@@ -467,6 +575,8 @@ void MainWindow::onNodeModified(NodeItem* node)
     return;
   }
 
+  LOG_WARN_ON_FAILURE(mPropertiesMenu->onNodeModified(node));
+
   if (canvas()->type() == Types::LibraryTypes::STRUCTURAL)
     LOG_WARN_ON_FAILURE(mSystemMenu->onNodeModified(node));
   else
@@ -487,13 +597,60 @@ void MainWindow::onCanvasTabChanged(int index)
   if (!mActiveCanvas)
     return;
 
+  // Released flows are repopulated before binding, the side panels already know their nodes
+  auto flowCanvas = dynamic_cast<BehaviourCanvas*>(mActiveCanvas);
+  if (flowCanvas)
+  {
+    flowCanvas->restore();
+
+    mFlowTabHistory.removeAll(newCanvas);
+    mFlowTabHistory.prepend(newCanvas);
+  }
+
   bindCanvas();
+  releaseInactiveFlows();
 
   auto libIndex = libraryTypeToIndex(mActiveCanvas->type());
   mNavigationTab->setCurrentIndex(libIndex);
   mLeftPanel->setCurrentIndex(libIndex);
 }
 
+void MainWindow::releaseInactiveFlows()
+{
+  const int budget = mSettingsManager->general().flowTabItemBudget;
+
+  int kept = 0;
+  bool released = false;
+  for (auto it = mFlowTabHistory.begin(); it != mFlowTabHistory.end();)
+  {
+    // Drop the tabs that were closed in the meantime
+    CanvasView* view = *it;
+    if (mCanvasPanel->indexOf(view) < 0)
+    {
+      it = mFlowTabHistory.erase(it);
+      continue;
+    }
+
+    ++it;
+
+    auto flowCanvas = dynamic_cast<BehaviourCanvas*>(view->scene());
+    if (!flowCanvas || flowCanvas == mActiveCanvas || flowCanvas->isReleased())
+      continue;
+
+    kept += flowCanvas->items().size();
+    if (kept <= budget)
+      continue;
+
+    LOG_DEBUG("Releasing flow tab %s", qPrintable(flowCanvas->id()));
+    flowCanvas->release();
+    released = true;
+  }
+
+  // The properties may still point to a node of a released flow
+  if (released)
+    LOG_WARN_ON_FAILURE(mPropertiesMenu->onNodeSelected(nullptr, false));
+}
+
 void MainWindow::closeCanvasTab(int index)
 {
   CanvasView* newCanvas = qobject_cast<CanvasView*>(mCanvasPanel->widget(index));
@@ -643,21 +800,3 @@ int MainWindow::libraryTypeToIndex(Types::LibraryTypes type) const
       return 0;
   }
 }
-
-void MainWindow::handleLogging(const QString& message, QTextBrowser* textBrowser)
-{
-  if (textBrowser)
-  {
-    textBrowser->append(message);
-
-    // Check if the number of lines exceeds the maximum limit
-    QTextDocument* doc = textBrowser->document();
-    if (doc->blockCount() > 100)
-    {
-      // Remove the first block (top line) to limit the number of lines
-      QTextBlock block = doc->begin();
-      textBrowser->textCursor().setPosition(block.position());
-      textBrowser->textCursor().removeSelectedText();
-    }
-  }
-}
\ No newline at end of file
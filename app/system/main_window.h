@@ -16,9 +16,14 @@
 #include "main_window_layout.h"
 #include "result.h"
 
+class LogSink;
+class NodePalette;
 class SaveHandler;
+class VerificationScheduler;
+struct LibraryInfo;
 class PluginManager;
 class SettingsManager;
+struct GeneralSettings;
 
 class MainWindow : public MainWindowlayout
 {
@@ -33,6 +38,7 @@ public:
 private slots:
   void onNodeSelected(NodeItem* node, bool selected);
   void onNodeAdded(NodeItem* node);
+  void onNodesAdded(const QList<NodeItem*>& nodes);
   void onNodeRemoved(NodeItem* node);
   void onNodeModified(NodeItem* node);
 
@@ -50,7 +56,15 @@ private:
   std::shared_ptr<Generator> mGenerator;
   Canvas* mActiveCanvas;
 
-  logging::LogLevel mLogLevel;
+  NodePalette* mNodePalette = nullptr;
+  // Where the cursor was when the palette was opened, the new node goes there
+  QPoint mPalettePosition;
+
+  // Flow tabs, most recently used first
+  QList<CanvasView*> mFlowTabHistory;
+
+  LogSink* mLogSink = nullptr;
+  VerificationScheduler* mVerificationScheduler = nullptr;
 
   std::shared_ptr<SaveInfo> mStorage;
 
@@ -59,8 +73,7 @@ private:
   Canvas* canvas() const;
   Canvas* rootCanvas() const;
   VoidResult loadElements();
-  VoidResult loadLibrary(const JSON& config);
-  VoidResult loadElementLibrary(const QString& name, const JSON& config);
+  VoidResult loadElementLibrary(const LibraryInfo& library);
 
   void bind();
   void bindCanvas();
@@ -70,12 +83,15 @@ private:
 
   void onCanvasTabChanged(int index);
   void closeCanvasTab(int index);
+  void releaseInactiveFlows();
+
+  void openNodePalette();
+  void addNodeFromPalette(const QString& nodeId);
 
   int libraryTypeToIndex(Types::LibraryTypes type) const;
 
   void onThemeChanged(const QString& t, const QList<Config::ThemeInfo>& at);
-
-  void handleLogging(const QString& message, QTextBrowser* textBrowser);
+  void onGeneralSettingsChanged(const GeneralSettings& settings);
 
   void addProcessTab();
 
@@ -22,6 +22,7 @@
 
 // Custom widgets
 #include "app_configs.h"
+#include "logging.h"
 #include "style_helpers.h"
 #include "system/canvas_view.h"
 #include "theme.h"
@@ -213,9 +214,8 @@ void MainWindowlayout::buildRightPanel()
   // Navigation Menu
   mNavigationTab = new QTabWidget();
 
+  // Columns and their names come from the model
   mSystemMenu = new SystemMenu(mNavigationTab);
-  mSystemMenu->setColumnCount(2);
-  mSystemMenu->setHeaderLabels({tr("Name"), tr("Type")});
   mSystemMenu->header()->setAlternatingRowColors(true);
   mSystemMenu->header()->setSectionResizeMode(0, QHeaderView::Stretch);
 
@@ -333,6 +333,16 @@ void MainWindowlayout::buildLogTab()
   warningButton->setToolTipDuration(2000);
   mIcons.append({warningButton, ":/icons/warning.svg", 0, QColor("yellow")});
 
+  // Messages below this level are dropped before they reach the views
+  mLogLevelComboBox = new QComboBox();
+  mLogLevelComboBox->setToolTip("Lowest level that is logged");
+  mLogLevelComboBox->setToolTipDuration(2000);
+  mLogLevelComboBox->addItem(tr("Error"), static_cast<int>(logging::LogLevel::Error));
+  mLogLevelComboBox->addItem(tr("Warning"), static_cast<int>(logging::LogLevel::Warning));
+  mLogLevelComboBox->addItem(tr("Info"), static_cast<int>(logging::LogLevel::Info));
+  mLogLevelComboBox->addItem(tr("Debug"), static_cast<int>(logging::LogLevel::Debugging));
+  mLogLevelComboBox->addItem(tr("Trace"), static_cast<int>(logging::LogLevel::Trace));
+
   QStackedWidget* logViews = new QStackedWidget();
 
   mLogText = new QTextBrowser(mBottomPanel);
@@ -368,6 +378,7 @@ void MainWindowlayout::buildLogTab()
   layout->addWidget(errorButton);
   layout->addWidget(warningButton);
   layout->addStretch();
+  layout->addWidget(mLogLevelComboBox);
   layout->addWidget(clearButton);
 
   logToolBar->addWidget(group);
@@ -1,21 +1,81 @@
 #include "process_tab.h"
 
+#include <QCoreApplication>
+#include <QDesktopServices>
+#include <QDir>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPointer>
+#include <QPushButton>
 #include <QScrollBar>
-#include <QTextBrowser>
+#include <QTextDocument>
+#include <QThreadPool>
+#include <QTimer>
+#include <QUrl>
 #include <QVBoxLayout>
 
+#include "app_configs.h"
+#include "logging.h"
+
+// Lines kept in the view, older ones are only in the log file
+static const int MAX_VISIBLE_LINES = 5000;
+// Characters waiting for a flush before the oldest ones are skipped
+static const int MAX_PENDING_CHARS = 256 * 1024;
+// Roughly 30 updates per second at most
+static const int FLUSH_INTERVAL_MS = 33;
+// The view and the log are searched the same way
+static const Qt::CaseSensitivity SEARCH_CASE = Qt::CaseInsensitive;
+
 ProcessTab::ProcessTab(QWidget* parent)
     : QWidget(parent)
-    , m_output(new QTextBrowser(this))
+    , m_output(new QPlainTextEdit(this))
+    , m_search(new QLineEdit(this))
+    , m_status(new QLabel(this))
     , m_process(new QProcess(this))
+    , m_skipped(0)
+    , m_flushTimer(new QTimer(this))
+    , m_log(QDir::temp().filePath("process-XXXXXX.log"))
+    , m_logSize(0)
+    , m_pendingOffset(0)
+    , m_lineOffsets({0})
+    , m_searchId(0)
+    , m_stdoutDecoder(QStringDecoder::System)
+    , m_stderrDecoder(QStringDecoder::System)
 {
+  // Plain text only lays out the visible lines
   m_output->setReadOnly(true);
+  m_output->setFont(Fonts::MonoSpace);
+  m_output->setMaximumBlockCount(MAX_VISIBLE_LINES);
   // m_output->setWordWrapMode(QTextOption::NoWrap);
 
+  m_search->setPlaceholderText(tr("Search output..."));
+  m_search->setClearButtonEnabled(true);
+
+  QPushButton* openLog = new QPushButton(tr("Full log"), this);
+  openLog->setToolTip(tr("Open everything the process wrote"));
+
+  auto* searchBar = new QHBoxLayout();
+  searchBar->addWidget(m_search);
+  searchBar->addWidget(m_status);
+  searchBar->addWidget(openLog);
+
   auto* layout = new QVBoxLayout(this);
   layout->setContentsMargins(0, 0, 0, 0);
+  layout->addLayout(searchBar);
   layout->addWidget(m_output);
 
+  m_flushTimer->setSingleShot(true);
+  m_flushTimer->setInterval(FLUSH_INTERVAL_MS);
+  connect(m_flushTimer, &QTimer::timeout, this, &ProcessTab::flush);
+
+  connect(m_search, &QLineEdit::returnPressed, this, &ProcessTab::search);
+  connect(openLog, &QPushButton::pressed, this, [this]() {
+    m_log.flush();
+    QDesktopServices::openUrl(QUrl::fromLocalFile(m_log.fileName()));
+  });
+
   // Merge stdout + stderr into one stream if you prefer
   m_process->setProcessChannelMode(QProcess::SeparateChannels);
 
@@ -27,26 +87,35 @@ ProcessTab::ProcessTab(QWidget* parent)
 
 void ProcessTab::startProcess(const QString& program, const QStringList& arguments)
 {
+  if (!m_log.isOpen() && !m_log.open())
+    LOG_WARNING("Could not create a log file for %s, only the latest output is kept", qPrintable(program));
+
   appendText(QString("> %1 %2\n\n").arg(program, arguments.join(' ')));
 
+  // Taken at every start, but without the Chromium flags set for the web views
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  env.remove(Constants::CHROMIUM_FLAGS_ENV);
+  m_process->setProcessEnvironment(env);
+
   m_process->start(program, arguments);
 }
 
 void ProcessTab::onReadyReadStandardOutput()
 {
-  const QString text = QString::fromLocal8Bit(m_process->readAllStandardOutput());
-  appendText(text);
+  appendText(m_stdoutDecoder.decode(m_process->readAllStandardOutput()));
 }
 
 void ProcessTab::onReadyReadStandardError()
 {
-  const QString text = QString::fromLocal8Bit(m_process->readAllStandardError());
-  appendText(text);
+  appendText(m_stderrDecoder.decode(m_process->readAllStandardError()));
 }
 
 void ProcessTab::onFinished(int exitCode, QProcess::ExitStatus status)
 {
   appendText(QString("\n[Process finished with code %1]\n").arg(exitCode));
+  flush();
+  m_log.flush();
+
   emit processFinished(exitCode, status);
 }
 
@@ -57,7 +126,150 @@ void ProcessTab::onErrorOccurred(QProcess::ProcessError error)
 
 void ProcessTab::appendText(const QString& text)
 {
-  m_output->moveCursor(QTextCursor::End);
-  m_output->append(text);
-  // m_output->verticalScrollBar()->setValue(m_output->verticalScrollBar()->maximum());
+  if (text.isEmpty())
+    return;
+
+  QByteArray data = text.toUtf8();
+  if (m_log.isOpen())
+    m_log.write(data);
+
+  if (m_pending.isEmpty())
+    m_pendingOffset = m_logSize;
+
+  m_logSize += data.size();
+  m_pending += text;
+
+  // Drop whole lines from the front, they can still be found in the log
+  if (m_pending.size() > MAX_PENDING_CHARS)
+  {
+    qsizetype cut = m_pending.indexOf('\n', m_pending.size() - MAX_PENDING_CHARS);
+    cut = cut < 0 ? m_pending.size() - MAX_PENDING_CHARS : cut + 1;
+
+    QStringView dropped = QStringView(m_pending).left(cut);
+    m_skipped += dropped.count('\n');
+    m_pendingOffset += dropped.toUtf8().size();
+    m_pending.remove(0, cut);
+  }
+
+  if (!m_flushTimer->isActive())
+    m_flushTimer->start();
+}
+
+void ProcessTab::flush()
+{
+  m_flushTimer->stop();
+  if (m_pending.isEmpty())
+    return;
+
+  QScrollBar* scrollBar = m_output->verticalScrollBar();
+  bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+  QTextCursor cursor(m_output->document());
+  cursor.movePosition(QTextCursor::End);
+  cursor.beginEditBlock();
+  if (m_skipped > 0)
+  {
+    cursor.insertText(QString("\n[... %1 lines skipped, see the full log ...]\n").arg(m_skipped));
+
+    // The marker is not in the log, its lines point to the output after it
+    m_lineOffsets.insert(m_lineOffsets.end(), 2, m_pendingOffset);
+  }
+
+  cursor.insertText(m_pending);
+  cursor.endEditBlock();
+
+  // Every new line starts a block, the view drops the oldest ones past its maximum
+  qint64 offset = m_pendingOffset;
+  qsizetype from = 0;
+  qsizetype end;
+  while ((end = m_pending.indexOf('\n', from)) >= 0)
+  {
+    offset += QStringView(m_pending).mid(from, end + 1 - from).toUtf8().size();
+    m_lineOffsets.push_back(offset);
+    from = end + 1;
+  }
+
+  while (m_lineOffsets.size() > size_t(MAX_VISIBLE_LINES))
+    m_lineOffsets.pop_front();
+
+  m_pending.clear();
+  m_skipped = 0;
+
+  // Only follow the output if the user was not scrolled up
+  if (atBottom)
+    scrollBar->setValue(scrollBar->maximum());
+}
+
+void ProcessTab::search()
+{
+  ++m_searchId;
+
+  const QString text = m_search->text();
+  if (text.isEmpty())
+  {
+    m_status->clear();
+    return;
+  }
+
+  QTextDocument::FindFlags flags;
+  if (SEARCH_CASE == Qt::CaseSensitive)
+    flags |= QTextDocument::FindCaseSensitively;
+
+  // Visible output first, wrapping around once
+  if (m_output->find(text, flags))
+  {
+    m_status->clear();
+    return;
+  }
+
+  QTextCursor start(m_output->document());
+  m_output->setTextCursor(start);
+  if (m_output->find(text, flags))
+  {
+    m_status->clear();
+    return;
+  }
+
+  if (!m_log.isOpen())
+  {
+    m_status->setText(tr("No matches"));
+    return;
+  }
+
+  // Only the output that already left the view, read on another thread so a
+  // long log does not block the window
+  m_log.flush();
+  m_status->setText(tr("Searching the full log..."));
+
+  QString fileName = m_log.fileName();
+  qint64 limit = m_lineOffsets.front();
+  quint64 searchId = m_searchId;
+  QPointer<ProcessTab> self(this);
+  QThreadPool::globalInstance()->start([self, fileName, limit, text, searchId]() {
+    int matches = 0;
+
+    QFile log(fileName);
+    if (log.open(QFile::ReadOnly))
+    {
+      while (log.pos() < limit && !log.atEnd())
+      {
+        if (QString::fromUtf8(log.readLine()).contains(text, SEARCH_CASE))
+          ++matches;
+      }
+    }
+
+    // The tab may be gone by now, so it is only looked at on the GUI thread
+    QMetaObject::invokeMethod(QCoreApplication::instance(), [self, searchId, matches]() {
+      if (self)
+        self->showLogMatches(searchId, matches);
+    }, Qt::QueuedConnection);
+  });
+}
+
+void ProcessTab::showLogMatches(quint64 searchId, int matches)
+{
+  if (searchId != m_searchId)
+    return;
+
+  m_status->setText(matches > 0 ? tr("%1 older matches in the full log").arg(matches) : tr("No matches"));
 }
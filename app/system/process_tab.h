@@ -1,9 +1,15 @@
 #pragma once
 
 #include <QProcess>
+#include <QStringDecoder>
+#include <QTemporaryFile>
 #include <QWidget>
+#include <deque>
 
-class QTextBrowser;
+class QLabel;
+class QLineEdit;
+class QPlainTextEdit;
+class QTimer;
 
 class ProcessTab : public QWidget
 {
@@ -26,8 +32,33 @@ private slots:
   void onErrorOccurred(QProcess::ProcessError error);
 
 private:
-  QTextBrowser* m_output;
+  QPlainTextEdit* m_output;
+  QLineEdit* m_search;
+  QLabel* m_status;
   QProcess* m_process;
 
+  // Output waiting for the next flush. Only the tail is kept if the process
+  // writes faster than we draw, the rest is still in the log file.
+  QString m_pending;
+  qint64 m_skipped;
+  QTimer* m_flushTimer;
+
+  // Everything the process wrote, the view only keeps the last lines
+  QTemporaryFile m_log;
+  qint64 m_logSize;
+  // Where m_pending starts in the log
+  qint64 m_pendingOffset;
+  // Where every line of the view starts in the log, the front is the oldest one
+  std::deque<qint64> m_lineOffsets;
+
+  // Searches of the log report back from another thread, older ones are ignored
+  quint64 m_searchId;
+
+  QStringDecoder m_stdoutDecoder;
+  QStringDecoder m_stderrDecoder;
+
   void appendText(const QString& text);
+  void flush();
+  void search();
+  void showLogMatches(quint64 searchId, int matches);
 };
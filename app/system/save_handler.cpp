@@ -58,10 +58,11 @@ VoidResult SaveHandler::saveToFile(Canvas* canvas)
       if (node->parentNode() != nullptr)
         continue;
 
+      // The storage is only written out, so there is no need to copy it
       if (node->function() == Types::LibraryTypes::STRUCTURAL)
-        info.structuralNodes.push_back(std::make_shared<NodeSaveInfo>(node->saveInfo()));
+        info.structuralNodes.push_back(node->storage());
       else
-        info.behaviouralNodes.push_back(std::make_shared<NodeSaveInfo>(node->saveInfo()));
+        info.behaviouralNodes.push_back(node->storage());
     }
   }
 
@@ -7,12 +7,14 @@
 #include <QVBoxLayout>
 #include <QWebEngineView>
 
+#include "app_configs.h"
+
 LocalServerTab::LocalServerTab(QWidget* parent)
     : QWidget(parent)
+    , m_view(nullptr)
 {
   m_urlEdit = new QLineEdit(this);
   m_reloadButton = new QPushButton(tr("Reload"), this);
-  m_view = new QWebEngineView(this);
 
   auto* topBarLayout = new QHBoxLayout();
   topBarLayout->setContentsMargins(0, 0, 0, 0);
@@ -23,14 +25,62 @@ LocalServerTab::LocalServerTab(QWidget* parent)
   auto* mainLayout = new QVBoxLayout(this);
   mainLayout->setContentsMargins(0, 0, 0, 0);
   mainLayout->addLayout(topBarLayout);
-  mainLayout->addWidget(m_view);
+  mainLayout->addStretch();
 
   connect(m_reloadButton, &QPushButton::clicked, this, &LocalServerTab::onReloadClicked);
   connect(m_urlEdit, &QLineEdit::returnPressed, this, &LocalServerTab::onReloadClicked);
+}
+
+void LocalServerTab::showEvent(QShowEvent* event)
+{
+  QWidget::showEvent(event);
+
+  if (m_view)
+    return;
+
+  createView();
+
+  if (!m_pendingUrl.isEmpty())
+    m_view->load(m_pendingUrl);
+
+  m_pendingUrl.clear();
+}
+
+void LocalServerTab::createView()
+{
+  // Only read when the first web view is created. Qt WebEngine offers no other
+  // way to pass them this late, the processes we start remove them again. We
+  // never show more than a single local page, so one renderer and no background
+  // traffic is plenty. Flags set by the user win.
+  static bool configured = false;
+  if (!configured && !qEnvironmentVariableIsSet(Constants::CHROMIUM_FLAGS_ENV))
+    qputenv(Constants::CHROMIUM_FLAGS_ENV, "--renderer-process-limit=1 --disable-background-networking --disable-extensions");
+
+  configured = true;
+
+  m_view = new QWebEngineView(this);
+
+  // Replace the placeholder stretch
+  auto* mainLayout = static_cast<QVBoxLayout*>(layout());
+  delete mainLayout->takeAt(mainLayout->count() - 1);
+  mainLayout->addWidget(m_view);
+
   connect(m_view, &QWebEngineView::loadStarted, this, &LocalServerTab::onLoadStarted);
   connect(m_view, &QWebEngineView::loadFinished, this, &LocalServerTab::onLoadFinished);
 }
 
+void LocalServerTab::load(const QUrl& url)
+{
+  // Loaded once the tab is shown for the first time
+  if (!m_view)
+  {
+    m_pendingUrl = url;
+    return;
+  }
+
+  m_view->load(url);
+}
+
 void LocalServerTab::connectToServer(const QString& host, quint16 port)
 {
   const QUrl url(QStringLiteral("http://%1:%2").arg(host).arg(port));
@@ -40,7 +90,7 @@ void LocalServerTab::connectToServer(const QString& host, quint16 port)
 void LocalServerTab::setUrl(const QUrl& url)
 {
   m_urlEdit->setText(url.toString());
-  m_view->load(url);
+  load(url);
 }
 
 void LocalServerTab::onReloadClicked()
@@ -48,7 +98,7 @@ void LocalServerTab::onReloadClicked()
   QUrl url = QUrl::fromUserInput(m_urlEdit->text());
   if (!url.isEmpty())
   {
-    m_view->load(url);
+    load(url);
   }
 }
 
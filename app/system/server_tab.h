@@ -20,6 +20,9 @@ public:
   // Or pass a full URL if you prefer
   void setUrl(const QUrl& url);
 
+protected:
+  void showEvent(QShowEvent* event) override;
+
 private slots:
   void onReloadClicked();
   void onLoadStarted();
@@ -28,5 +31,11 @@ private slots:
 private:
   QLineEdit* m_urlEdit;
   QPushButton* m_reloadButton;
+
+  // Starting Chromium is expensive, so the view is only created once the tab is shown
   QWebEngineView* m_view;
+  QUrl m_pendingUrl;
+
+  void createView();
+  void load(const QUrl& url);
 };
@@ -0,0 +1,260 @@
+#include "spatial_index.h"
+
+#include <QSet>
+#include <cmath>
+
+// Items covering more cells than this go to a coarser level
+static constexpr int MAX_CELLS_PER_ITEM = 64;
+// Cell size ratio between two consecutive levels
+static constexpr qreal LEVEL_FACTOR = 8.0;
+// Bounds anything that is not absurdly large, the last level takes the rest
+static constexpr int MAX_LEVELS = 12;
+
+SpatialIndex::SpatialIndex(qreal cellSize)
+    : mCellSize(cellSize)
+    , mNextOrder(1)
+    , mExtentDirty(false)
+{
+}
+
+quint64 SpatialIndex::cellKey(int x, int y)
+{
+  return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+QRect SpatialIndex::cellsFor(const QRectF& bounds, qreal cellSize) const
+{
+  int left = int(std::floor(bounds.left() / cellSize));
+  int top = int(std::floor(bounds.top() / cellSize));
+  int right = int(std::floor(bounds.right() / cellSize));
+  int bottom = int(std::floor(bounds.bottom() / cellSize));
+
+  return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+int SpatialIndex::levelFor(const QRectF& bounds)
+{
+  int level = 0;
+  qreal cellSize = mCellSize;
+  while (level < MAX_LEVELS - 1)
+  {
+    QRect cells = cellsFor(bounds, cellSize);
+    if (qint64(cells.width()) * cells.height() <= MAX_CELLS_PER_ITEM)
+      break;
+
+    cellSize *= LEVEL_FACTOR;
+    ++level;
+  }
+
+  while (mLevels.size() <= level)
+    mLevels.push_back({mCellSize * std::pow(LEVEL_FACTOR, mLevels.size()), {}});
+
+  return level;
+}
+
+void SpatialIndex::addToCells(QGraphicsItem* item, int level, const QRect& cells)
+{
+  auto& grid = mLevels[level].cells;
+  for (int x = cells.left(); x <= cells.right(); ++x)
+  {
+    for (int y = cells.top(); y <= cells.bottom(); ++y)
+      grid[cellKey(x, y)].push_back(item);
+  }
+}
+
+void SpatialIndex::removeFromCells(QGraphicsItem* item, int level, const QRect& cells)
+{
+  auto& grid = mLevels[level].cells;
+  for (int x = cells.left(); x <= cells.right(); ++x)
+  {
+    for (int y = cells.top(); y <= cells.bottom(); ++y)
+    {
+      auto cell = grid.find(cellKey(x, y));
+      if (cell == grid.end())
+        continue;
+
+      cell->removeOne(item);
+      if (cell->isEmpty())
+        grid.erase(cell);
+    }
+  }
+}
+
+void SpatialIndex::growExtent(const QRectF& bounds)
+{
+  if (mExtentDirty)
+    return;
+
+  mExtent = mEntries.size() == 1 ? bounds : mExtent.united(bounds);
+}
+
+void SpatialIndex::shrinkExtent(const QRectF& bounds)
+{
+  if (mExtentDirty)
+    return;
+
+  // Only items on the edge can make the extent smaller
+  if (bounds.left() <= mExtent.left() || bounds.top() <= mExtent.top() ||
+      bounds.right() >= mExtent.right() || bounds.bottom() >= mExtent.bottom())
+    mExtentDirty = true;
+}
+
+void SpatialIndex::insert(QGraphicsItem* item, const QRectF& bounds)
+{
+  int level = levelFor(bounds);
+  QRect cells = cellsFor(bounds, mLevels[level].cellSize);
+
+  auto entry = mEntries.find(item);
+  if (entry != mEntries.end())
+  {
+    shrinkExtent(entry->bounds);
+
+    // Moving inside the same cells only needs the new bounds
+    if (entry->level == level && entry->cells == cells)
+    {
+      entry->bounds = bounds;
+      growExtent(bounds);
+      return;
+    }
+
+    removeFromCells(item, entry->level, entry->cells);
+
+    entry->bounds = bounds;
+    entry->cells = cells;
+    entry->level = level;
+  }
+  else
+  {
+    mEntries.insert(item, {bounds, cells, level, mNextOrder++});
+  }
+
+  addToCells(item, level, cells);
+  growExtent(bounds);
+}
+
+void SpatialIndex::remove(QGraphicsItem* item)
+{
+  auto entry = mEntries.find(item);
+  if (entry == mEntries.end())
+    return;
+
+  shrinkExtent(entry->bounds);
+  removeFromCells(item, entry->level, entry->cells);
+
+  mEntries.erase(entry);
+}
+
+void SpatialIndex::clear()
+{
+  mLevels.clear();
+  mEntries.clear();
+
+  mExtent = QRectF();
+  mExtentDirty = false;
+}
+
+bool SpatialIndex::contains(QGraphicsItem* item) const
+{
+  return mEntries.contains(item);
+}
+
+qsizetype SpatialIndex::size() const
+{
+  return mEntries.size();
+}
+
+QRectF SpatialIndex::bounds(QGraphicsItem* item) const
+{
+  auto entry = mEntries.find(item);
+  return entry == mEntries.end() ? QRectF() : entry->bounds;
+}
+
+quint64 SpatialIndex::order(const QGraphicsItem* item) const
+{
+  auto entry = mEntries.find(const_cast<QGraphicsItem*>(item));
+  return entry == mEntries.end() ? 0 : entry->order;
+}
+
+QRectF SpatialIndex::extent() const
+{
+  if (mExtentDirty)
+  {
+    mExtent = QRectF();
+    for (const Entry& entry : mEntries)
+      mExtent = mExtent.isNull() ? entry.bounds : mExtent.united(entry.bounds);
+
+    mExtentDirty = false;
+  }
+
+  return mExtent;
+}
+
+QList<QGraphicsItem*> SpatialIndex::query(const QPointF& point) const
+{
+  QList<QGraphicsItem*> result;
+
+  for (const Level& level : mLevels)
+  {
+    QRect cell = cellsFor(QRectF(point, point), level.cellSize);
+    auto bucket = level.cells.find(cellKey(cell.left(), cell.top()));
+    if (bucket == level.cells.end())
+      continue;
+
+    for (QGraphicsItem* item : *bucket)
+    {
+      if (mEntries.value(item).bounds.contains(point))
+        result.push_back(item);
+    }
+  }
+
+  return result;
+}
+
+QList<QGraphicsItem*> SpatialIndex::query(const QRectF& area) const
+{
+  QList<QGraphicsItem*> result;
+  QSet<QGraphicsItem*> visited;
+
+  auto test = [&](QGraphicsItem* item)
+  {
+    // Items spanning several cells show up more than once
+    if (visited.contains(item))
+      return;
+
+    visited.insert(item);
+    if (mEntries.value(item).bounds.intersects(area))
+      result.push_back(item);
+  };
+
+  for (const Level& level : mLevels)
+  {
+    // When zoomed out the area can cover more cells than there are occupied ones,
+    // in which case walking the occupied cells is cheaper than walking the grid
+    QRect cells = cellsFor(area.normalized(), level.cellSize);
+    if (qint64(cells.width()) * cells.height() > level.cells.size())
+    {
+      for (const auto& bucket : level.cells)
+      {
+        for (QGraphicsItem* item : bucket)
+          test(item);
+      }
+
+      continue;
+    }
+
+    for (int x = cells.left(); x <= cells.right(); ++x)
+    {
+      for (int y = cells.top(); y <= cells.bottom(); ++y)
+      {
+        auto bucket = level.cells.find(cellKey(x, y));
+        if (bucket == level.cells.end())
+          continue;
+
+        for (QGraphicsItem* item : *bucket)
+          test(item);
+      }
+    }
+  }
+
+  return result;
+}
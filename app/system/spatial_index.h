@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QRectF>
+#include <QVector>
+
+class QGraphicsItem;
+
+// Hierarchy of uniform grids over the scene used for hit testing and area queries.
+// Items are bucketed by their scene bounds in the finest grid they fit in, so moving
+// an item only touches the cells it leaves and enters instead of rebuilding a tree.
+class SpatialIndex
+{
+public:
+  SpatialIndex(qreal cellSize = 256.0);
+
+  void insert(QGraphicsItem* item, const QRectF& bounds);
+  void remove(QGraphicsItem* item);
+  void clear();
+
+  bool contains(QGraphicsItem* item) const;
+  qsizetype size() const;
+
+  // Items whose indexed bounds contain the point
+  QList<QGraphicsItem*> query(const QPointF& point) const;
+  // Items whose indexed bounds intersect the area
+  QList<QGraphicsItem*> query(const QRectF& area) const;
+
+  QRectF bounds(QGraphicsItem* item) const;
+  // Order in which the item was first inserted, 0 if it is not indexed. Moving
+  // an item keeps its order, like the insertion order Qt stacks siblings by.
+  quint64 order(const QGraphicsItem* item) const;
+
+  // Union of all indexed bounds, empty when nothing is indexed
+  QRectF extent() const;
+
+private:
+  struct Entry
+  {
+    QRectF bounds;
+    QRect cells;
+    int level;
+    quint64 order;
+  };
+
+  struct Level
+  {
+    qreal cellSize;
+    QHash<quint64, QVector<QGraphicsItem*>> cells;
+  };
+
+  const qreal mCellSize;
+  quint64 mNextOrder;
+
+  // Each level has cells a fixed factor larger than the one before, levels are
+  // added as larger items show up
+  QVector<Level> mLevels;
+  QHash<QGraphicsItem*, Entry> mEntries;
+
+  // Only recomputed when an item on the edge of the extent moves inwards or leaves
+  mutable QRectF mExtent;
+  mutable bool mExtentDirty;
+
+  QRect cellsFor(const QRectF& bounds, qreal cellSize) const;
+  int levelFor(const QRectF& bounds);
+  void addToCells(QGraphicsItem* item, int level, const QRect& cells);
+  void removeFromCells(QGraphicsItem* item, int level, const QRect& cells);
+
+  void growExtent(const QRectF& bounds);
+  void shrinkExtent(const QRectF& bounds);
+
+  static quint64 cellKey(int x, int y);
+};
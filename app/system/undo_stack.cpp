@@ -0,0 +1,152 @@
+#include "undo_stack.h"
+
+int Command::id() const
+{
+  return -1;
+}
+
+bool Command::mergeWith(const Command* /* other */)
+{
+  return false;
+}
+
+qsizetype Command::cost() const
+{
+  return sizeof(*this);
+}
+
+UndoStack::UndoStack(qsizetype memoryBudget)
+    : mIndex(0)
+    , mCost(0)
+    , mBudget(memoryBudget)
+    , mApplying(false)
+{
+}
+
+void UndoStack::push(std::unique_ptr<Command> command)
+{
+  if (!command)
+    return;
+
+  dropRedo();
+
+  if (!mCommands.empty())
+  {
+    Entry& top = mCommands.back();
+    if (command->id() != -1 && top.command->id() == command->id() && top.command->mergeWith(command.get()))
+    {
+      refresh(top);
+      trim();
+      return;
+    }
+  }
+
+  qsizetype cost = command->cost();
+  mCost += cost;
+  mCommands.push_back({std::move(command), cost});
+  mIndex = mCommands.size();
+
+  trim();
+}
+
+void UndoStack::execute(std::unique_ptr<Command> command)
+{
+  if (!command)
+    return;
+
+  mApplying = true;
+  command->redo();
+  mApplying = false;
+
+  push(std::move(command));
+}
+
+void UndoStack::undo()
+{
+  if (!canUndo())
+    return;
+
+  Entry& entry = mCommands[--mIndex];
+
+  mApplying = true;
+  entry.command->undo();
+  mApplying = false;
+
+  refresh(entry);
+}
+
+void UndoStack::redo()
+{
+  if (!canRedo())
+    return;
+
+  Entry& entry = mCommands[mIndex++];
+
+  mApplying = true;
+  entry.command->redo();
+  mApplying = false;
+
+  refresh(entry);
+  trim();
+}
+
+bool UndoStack::canUndo() const
+{
+  return !mApplying && mIndex > 0;
+}
+
+bool UndoStack::canRedo() const
+{
+  return !mApplying && mIndex < mCommands.size();
+}
+
+void UndoStack::clear()
+{
+  mCommands.clear();
+  mIndex = 0;
+  mCost = 0;
+}
+
+bool UndoStack::isApplying() const
+{
+  return mApplying;
+}
+
+void UndoStack::setMemoryBudget(qsizetype budget)
+{
+  mBudget = budget;
+  trim();
+}
+
+qsizetype UndoStack::memoryUsage() const
+{
+  return mCost;
+}
+
+void UndoStack::dropRedo()
+{
+  while (mCommands.size() > mIndex)
+  {
+    mCost -= mCommands.back().cost;
+    mCommands.pop_back();
+  }
+}
+
+void UndoStack::refresh(Entry& entry)
+{
+  qsizetype cost = entry.command->cost();
+  mCost += cost - entry.cost;
+  entry.cost = cost;
+}
+
+void UndoStack::trim()
+{
+  // Only done commands are forgotten, and the latest one is always kept even
+  // if it is over budget on its own
+  while (mCost > mBudget && mIndex > 1)
+  {
+    mCost -= mCommands.front().cost;
+    mCommands.pop_front();
+    --mIndex;
+  }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QtGlobal>
+#include <deque>
+#include <memory>
+
+// A reversible edit, pushed to the stack once it has been applied
+class Command
+{
+public:
+  virtual ~Command() = default;
+
+  virtual void undo() = 0;
+  virtual void redo() = 0;
+
+  // Commands sharing an id other than -1 are offered to mergeWith, so that
+  // e.g. every keystroke in a property does not end up as its own step
+  virtual int id() const;
+  virtual bool mergeWith(const Command* other);
+
+  // Rough number of bytes held by the command
+  virtual qsizetype cost() const;
+};
+
+// Undo history that forgets the oldest commands once they take more memory
+// than the budget allows
+class UndoStack
+{
+public:
+  UndoStack(qsizetype memoryBudget);
+
+  // Stores a command that has already been applied
+  void push(std::unique_ptr<Command> command);
+  // Applies the command and stores it
+  void execute(std::unique_ptr<Command> command);
+
+  void undo();
+  void redo();
+  bool canUndo() const;
+  bool canRedo() const;
+  void clear();
+
+  // Edits made while a command is applied must not be recorded again
+  bool isApplying() const;
+
+  void setMemoryBudget(qsizetype budget);
+  qsizetype memoryUsage() const;
+
+private:
+  struct Entry
+  {
+    std::unique_ptr<Command> command;
+    qsizetype cost;
+  };
+
+  // Commands may hold more or less data after being applied, so their cost is
+  // refreshed every time
+  std::deque<Entry> mCommands;
+
+  // Commands before this index are done, the ones after it can be redone
+  size_t mIndex;
+  qsizetype mCost;
+  qsizetype mBudget;
+  bool mApplying;
+
+  void dropRedo();
+  void refresh(Entry& entry);
+  void trim();
+};
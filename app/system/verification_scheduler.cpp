@@ -0,0 +1,273 @@
+#include "verification_scheduler.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+
+#include "logging.h"
+
+// Model checking a large component can take a while
+static const int VERIFICATION_TIMEOUT_MS = 10 * 60 * 1000;
+static const quint32 CACHE_FORMAT = 2;
+
+VerificationScheduler::VerificationScheduler(QObject* parent)
+    : QObject(parent)
+    , mRunner(new ProcessRunner(this))
+    , mExecutable(QStandardPaths::findExecutable("dzn"))
+    , mGeneration(0)
+    , mActive(false)
+    , mMaxJobs(qMax(1, QThread::idealThreadCount()))
+    , mPassed(0)
+    , mFailed(0)
+    , mErrors(0)
+{
+  mRunner->setTimeout(VERIFICATION_TIMEOUT_MS);
+
+  if (isAvailable())
+  {
+    QFileInfo executable(mExecutable);
+    mToolId = QStringLiteral("%1 %2 %3")
+                  .arg(executable.canonicalFilePath())
+                  .arg(executable.lastModified().toMSecsSinceEpoch())
+                  .arg(executable.size())
+                  .toUtf8();
+  }
+
+  loadCache();
+}
+
+bool VerificationScheduler::isAvailable() const
+{
+  return !mExecutable.isEmpty();
+}
+
+void VerificationScheduler::verify(const QStringList& files)
+{
+  cancel();
+
+  if (!isAvailable())
+  {
+    LOG_WARNING("dzn was not found in the PATH, skipping the verification");
+    return;
+  }
+
+  mActive = true;
+  mPassed = 0;
+  mFailed = 0;
+  mErrors = 0;
+  mSeen.clear();
+  emit started();
+
+  QStringList models = files;
+  models.removeDuplicates();
+  for (const QString& file : models)
+  {
+    emit jobQueued(file);
+
+    QByteArray hash = contentHash(file);
+    if (hash.isEmpty())
+    {
+      finish(file, Outcome::Error, "Could not read " + file, false);
+      continue;
+    }
+
+    mSeen.insert(hash);
+
+    auto cached = mCache.constFind(hash);
+    if (cached != mCache.constEnd())
+    {
+      finish(file, cached->passed ? Outcome::Passed : Outcome::Failed, cached->output, true);
+      continue;
+    }
+
+    mHashes.insert(file, hash);
+    mQueue.enqueue(file);
+  }
+
+  LOG_INFO("Verifying %lld of %lld models on %d jobs", qint64(mQueue.size()), qint64(models.size()), mMaxJobs);
+
+  startNext();
+}
+
+void VerificationScheduler::cancel()
+{
+  ++mGeneration;
+  mActive = false;
+
+  mQueue.clear();
+  mHashes.clear();
+
+  for (ProcessRunner::JobId id : mRunning)
+    mRunner->cancel(id);
+
+  mRunning.clear();
+}
+
+void VerificationScheduler::startNext()
+{
+  while (mRunning.size() < mMaxJobs && !mQueue.isEmpty())
+  {
+    QString file = mQueue.dequeue();
+    QByteArray hash = mHashes.take(file);
+
+    // Imports are resolved from the folder of the model
+    mRunner->setCwd(QFileInfo(file).absolutePath());
+
+    emit jobStarted(file);
+
+    quint64 generation = mGeneration;
+    auto id = mRunner->runAsync(QStringLiteral("\"%1\" verify \"%2\"").arg(mExecutable, file), [this, file, hash, generation](int exitCode, const QString& output) {
+      if (generation != mGeneration)
+        return;
+
+      mRunning.remove(file);
+
+      // -1 means it never ran to completion, which says nothing about the model
+      if (exitCode == -1)
+      {
+        finish(file, Outcome::Error, output, false);
+      }
+      else
+      {
+        mCache.insert(hash, {exitCode == 0, output});
+        finish(file, exitCode == 0 ? Outcome::Passed : Outcome::Failed, output, false);
+      }
+
+      startNext();
+    });
+
+    // A process that failed to start already reported back
+    if (mRunner->isRunning(id))
+      mRunning.insert(file, id);
+  }
+
+  if (mActive && mQueue.isEmpty() && mRunning.isEmpty())
+  {
+    mActive = false;
+
+    // Only the models of the latest request are kept, so the cache does not grow
+    // with every edit
+    mCache.removeIf([this](const auto& entry) { return !mSeen.contains(entry.key()); });
+    saveCache();
+    emit allFinished(mPassed, mFailed, mErrors);
+  }
+}
+
+void VerificationScheduler::finish(const QString& file, Outcome outcome, const QString& output, bool cached)
+{
+  if (outcome == Outcome::Passed)
+    ++mPassed;
+  else if (outcome == Outcome::Failed)
+    ++mFailed;
+  else
+    ++mErrors;
+
+  emit jobFinished(file, outcome, output, cached);
+}
+
+QByteArray VerificationScheduler::contentHash(const QString& file) const
+{
+  static const QRegularExpression IMPORT_REGEX(R"(^\s*import\s+([^;\s]+)\s*;)", QRegularExpression::MultilineOption);
+
+  // A component must be verified again when one of its interfaces changes
+  QCryptographicHash hasher(QCryptographicHash::Sha1);
+  hasher.addData(mToolId);
+
+  QSet<QString> visited;
+  QStringList pending = {QFileInfo(file).absoluteFilePath()};
+
+  while (!pending.isEmpty())
+  {
+    QString path = pending.takeFirst();
+    if (visited.contains(path))
+      continue;
+
+    visited.insert(path);
+
+    QFile model(path);
+    if (!model.open(QFile::ReadOnly))
+    {
+      // Only the model itself is required, imports may come from the include path
+      if (visited.size() == 1)
+        return QByteArray();
+
+      continue;
+    }
+
+    QByteArray data = model.readAll();
+    hasher.addData(path.toUtf8());
+    hasher.addData(data);
+
+    QDir dir = QFileInfo(path).absoluteDir();
+    auto matches = IMPORT_REGEX.globalMatch(QString::fromUtf8(data));
+    while (matches.hasNext())
+      pending.push_back(dir.absoluteFilePath(matches.next().captured(1)));
+  }
+
+  return hasher.result();
+}
+
+QString VerificationScheduler::cachePath() const
+{
+  return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("verification.bin");
+}
+
+void VerificationScheduler::loadCache()
+{
+  QFile file(cachePath());
+  if (!file.open(QFile::ReadOnly))
+    return;
+
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_6_0);
+
+  quint32 format = 0;
+  quint32 count = 0;
+  in >> format >> count;
+  if (format != CACHE_FORMAT)
+    return;
+
+  for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+  {
+    QByteArray hash;
+    Verdict verdict;
+    in >> hash >> verdict.passed >> verdict.output;
+    mCache.insert(hash, verdict);
+  }
+
+  if (in.status() != QDataStream::Ok)
+  {
+    LOG_WARNING("Verification cache is corrupted, starting from scratch");
+    mCache.clear();
+  }
+}
+
+void VerificationScheduler::saveCache() const
+{
+  QString path = cachePath();
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QSaveFile file(path);
+  if (!file.open(QFile::WriteOnly))
+  {
+    LOG_WARNING("Could not write the verification cache: %s", qPrintable(file.errorString()));
+    return;
+  }
+
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_6_0);
+
+  out << CACHE_FORMAT << quint32(mCache.size());
+  for (auto it = mCache.cbegin(); it != mCache.cend(); ++it)
+    out << it.key() << it->passed << it->output;
+
+  if (!file.commit())
+    LOG_WARNING("Could not write the verification cache: %s", qPrintable(file.errorString()));
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "process_runner.h"
+
+// Verifies the generated Dezyne models, one job per file. As many jobs run at
+// the same time as there are cores. Results are cached by the dzn executable and
+// the contents of the file and the files it imports, so only modified components
+// are verified again.
+class VerificationScheduler : public QObject
+{
+  Q_OBJECT
+public:
+  enum class Outcome
+  {
+    Passed,
+    Failed,
+    // dzn did not run to completion, e.g. it timed out or could not start
+    Error
+  };
+  Q_ENUM(Outcome)
+
+  VerificationScheduler(QObject* parent = nullptr);
+
+  // Cancels whatever is still running from the previous request
+  void verify(const QStringList& files);
+  void cancel();
+
+  bool isAvailable() const;
+
+signals:
+  void started();
+  void jobQueued(const QString& file);
+  void jobStarted(const QString& file);
+  void jobFinished(const QString& file, VerificationScheduler::Outcome outcome, const QString& output, bool cached);
+  void allFinished(int passed, int failed, int errors);
+
+private:
+  struct Verdict
+  {
+    bool passed;
+    QString output;
+  };
+
+  ProcessRunner* mRunner;
+  QString mExecutable;
+
+  QQueue<QString> mQueue;
+  QHash<QString, QByteArray> mHashes;
+  QHash<QString, ProcessRunner::JobId> mRunning;
+  QHash<QByteArray, Verdict> mCache;
+  // Hashes of the models in the current request, the rest is dropped from the cache
+  QSet<QByteArray> mSeen;
+  // Identifies the dzn build, a different one may judge the same model differently
+  QByteArray mToolId;
+
+  // Jobs from a cancelled request still report back, they are told apart by this
+  quint64 mGeneration;
+  bool mActive;
+  int mMaxJobs;
+  int mPassed;
+  int mFailed;
+  int mErrors;
+
+  void startNext();
+  void finish(const QString& file, Outcome outcome, const QString& output, bool cached);
+
+  QByteArray contentHash(const QString& file) const;
+
+  QString cachePath() const;
+  void loadCache();
+  void saveCache() const;
+};
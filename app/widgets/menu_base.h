@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QList>
+
 #include "result.h"
 
 class NodeItem;
@@ -11,4 +13,13 @@ public:
   virtual VoidResult onNodeRemoved(NodeItem* node) = 0;
   virtual VoidResult onNodeModified(NodeItem* node) = 0;
   virtual VoidResult onNodeSelected(NodeItem* node, bool selected) = 0;
+
+  // Nodes created together, parents always come before their children
+  virtual VoidResult onNodesAdded(const QList<NodeItem*>& nodes)
+  {
+    for (NodeItem* node : nodes)
+      RETURN_ON_FAILURE(onNodeAdded(node));
+
+    return VoidResult();
+  }
 };
@@ -0,0 +1,210 @@
+#include "node_palette.h"
+
+#include <QCoreApplication>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+#include <algorithm>
+
+#include "logging.h"
+#include "system/config_table.h"
+
+// More results than this are never looked at
+static const int MAX_RESULTS = 50;
+
+NodePalette::NodePalette(QWidget* parent)
+    : QDialog(parent, Qt::Popup)
+{
+  QVBoxLayout* layout = new QVBoxLayout(this);
+  layout->setContentsMargins(4, 4, 4, 4);
+  setLayout(layout);
+
+  mSearch = new QLineEdit(this);
+  mSearch->setPlaceholderText(tr("Search nodes..."));
+  mSearch->installEventFilter(this);
+  layout->addWidget(mSearch);
+
+  mResults = new QListWidget(this);
+  layout->addWidget(mResults);
+
+  connect(mSearch, &QLineEdit::textChanged, this, &NodePalette::search);
+  connect(mResults, &QListWidget::itemActivated, this, &NodePalette::accept);
+}
+
+void NodePalette::buildIndex(std::shared_ptr<ConfigurationTable> configTable)
+{
+  mEntries.clear();
+  if (!configTable)
+    return;
+
+  for (const Symbol& key : configTable->keys())
+  {
+    auto config = configTable->get(key);
+    if (!config)
+      continue;
+
+    Entry entry;
+    entry.nodeId = key.toString();
+    entry.type = config->type;
+    entry.library = entry.nodeId.section("::", 0, 0);
+    entry.libraryType = config->libraryType;
+    entry.typeKey = entry.type.toLower();
+    entry.libraryKey = entry.library.toLower();
+    entry.helpKey = config->help.message.toLower();
+
+    mEntries.push_back(entry);
+  }
+
+  std::sort(mEntries.begin(), mEntries.end(), [](const Entry& a, const Entry& b) {
+    return a.library == b.library ? a.type < b.type : a.library < b.library;
+  });
+
+  LOG_DEBUG("Node palette indexed %lld nodes", qint64(mEntries.size()));
+}
+
+void NodePalette::openFor(Types::LibraryTypes libraryType)
+{
+  mLibraryType = libraryType;
+
+  mSearch->clear();
+  search(QString());
+
+  // Follows the window, but never smaller than what the widgets ask for
+  QSize size = sizeHint();
+  if (parentWidget())
+  {
+    QSize window = parentWidget()->window()->size();
+    size = size.expandedTo(QSize(window.width() / 3, window.height() / 2));
+  }
+  resize(size);
+
+  if (parentWidget())
+    move(parentWidget()->mapToGlobal(parentWidget()->rect().center()) - rect().center());
+
+  show();
+  mSearch->setFocus();
+}
+
+int NodePalette::fuzzyScore(const QString& query, const QString& text)
+{
+  if (query.isEmpty())
+    return 0;
+
+  // Every character of the query must appear in order, runs of consecutive
+  // characters and matches at the start of a word are worth more
+  int score = 0;
+  int last = -2;
+  int q = 0;
+  for (int i = 0; i < text.size() && q < query.size(); ++i)
+  {
+    if (text[i] != query[q])
+      continue;
+
+    score += 1;
+    if (i == last + 1)
+      score += 5;
+    if (i == 0 || !text[i - 1].isLetterOrNumber())
+      score += 8;
+
+    last = i;
+    ++q;
+  }
+
+  if (q < query.size())
+    return -1;
+
+  if (text.startsWith(query))
+    score += 40;
+  else if (text.contains(query))
+    score += 20;
+
+  return score;
+}
+
+void NodePalette::search(const QString& text)
+{
+  mResults->clear();
+
+  const QStringList terms = text.toLower().split(' ', Qt::SkipEmptyParts);
+
+  QVector<std::pair<int, const Entry*>> matches;
+  for (const Entry& entry : mEntries)
+  {
+    if (entry.libraryType != mLibraryType)
+      continue;
+
+    // Each word may match a different field, e.g. "ros pub"
+    int total = 0;
+    for (const QString& term : terms)
+    {
+      int typeScore = fuzzyScore(term, entry.typeKey);
+      int libraryScore = fuzzyScore(term, entry.libraryKey);
+      int best = std::max(typeScore >= 0 ? typeScore * 3 : -1, libraryScore >= 0 ? libraryScore * 2 : -1);
+
+      // Help texts are long enough to contain almost any subsequence
+      if (best < 0 && entry.helpKey.contains(term))
+        best = 1;
+
+      if (best < 0)
+      {
+        total = -1;
+        break;
+      }
+
+      total += best;
+    }
+
+    if (total >= 0)
+      matches.push_back({total, &entry});
+  }
+
+  // The entries are already in library order, which is kept for equal scores
+  std::stable_sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+    return a.first > b.first;
+  });
+
+  for (int i = 0; i < matches.size() && i < MAX_RESULTS; ++i)
+  {
+    const Entry* entry = matches[i].second;
+    QListWidgetItem* item = new QListWidgetItem(QStringLiteral("%1  (%2)").arg(entry->type, entry->library), mResults);
+    item->setData(Qt::UserRole, entry->nodeId);
+  }
+
+  mResults->setCurrentRow(0);
+}
+
+void NodePalette::accept()
+{
+  QListWidgetItem* item = mResults->currentItem();
+  QDialog::accept();
+
+  if (item)
+    emit nodeSelected(item->data(Qt::UserRole).toString());
+}
+
+bool NodePalette::eventFilter(QObject* object, QEvent* event)
+{
+  // Keep the focus in the search field while moving through the results
+  if (object == mSearch && event->type() == QEvent::KeyPress)
+  {
+    auto keyEvent = static_cast<QKeyEvent*>(event);
+    switch (keyEvent->key())
+    {
+      case Qt::Key_Up:
+      case Qt::Key_Down:
+      case Qt::Key_PageUp:
+      case Qt::Key_PageDown:
+        QCoreApplication::sendEvent(mResults, event);
+        return true;
+      case Qt::Key_Return:
+      case Qt::Key_Enter:
+        accept();
+        return true;
+      default:
+        break;
+    }
+  }
+
+  return QDialog::eventFilter(object, event);
+}
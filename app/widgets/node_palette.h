@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QDialog>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+#include "types.h"
+
+class QLineEdit;
+class QListWidget;
+class ConfigurationTable;
+
+// Quick search over every node type in the libraries
+class NodePalette : public QDialog
+{
+  Q_OBJECT
+public:
+  NodePalette(QWidget* parent = nullptr);
+
+  // The index is built once, after all the libraries were loaded
+  void buildIndex(std::shared_ptr<ConfigurationTable> configTable);
+
+  // Only nodes that can be placed in the given canvas are listed
+  void openFor(Types::LibraryTypes libraryType);
+
+signals:
+  void nodeSelected(const QString& nodeId);
+
+protected:
+  bool eventFilter(QObject* object, QEvent* event) override;
+
+private:
+  struct Entry
+  {
+    QString nodeId;
+    QString type;
+    QString library;
+    Types::LibraryTypes libraryType;
+
+    // Lower case copies, so that searching does not allocate
+    QString typeKey;
+    QString libraryKey;
+    QString helpKey;
+  };
+
+  QVector<Entry> mEntries;
+  Types::LibraryTypes mLibraryType = Types::LibraryTypes::UNKNOWN;
+
+  QLineEdit* mSearch = nullptr;
+  QListWidget* mResults = nullptr;
+
+  void search(const QString& text);
+  void accept() override;
+
+  static int fuzzyScore(const QString& query, const QString& text);
+};
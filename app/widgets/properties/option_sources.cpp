@@ -0,0 +1,160 @@
+#include "option_sources.h"
+
+#include "elements/save_info.h"
+
+static bool ownsConstruct(const NodeSaveInfo& node, const QString& constructId)
+{
+  auto contains = [&constructId](const QVector<std::shared_ptr<NodeSaveInfo>>& constructs) {
+    for (const auto& construct : constructs)
+    {
+      if (construct->id == constructId)
+        return true;
+    }
+
+    return false;
+  };
+
+  if (node.behaviour && contains(node.behaviour->nodes))
+    return true;
+
+  for (const auto& flow : node.flows)
+  {
+    if (contains(flow->nodes))
+      return true;
+  }
+
+  return false;
+}
+
+OptionSources::OptionSources()
+    : mStructureVersion(1)
+    , mFieldsVersion(1)
+    , mIndexVersion(0)
+    , mStatesVersion(0)
+    , mStatesFieldsVersion(0)
+{
+}
+
+void OptionSources::setStorage(std::shared_ptr<SaveInfo> storage)
+{
+  mStorage = storage;
+
+  // Nothing computed for the previous storage is valid anymore
+  mOwners.clear();
+  mFamilies.clear();
+  structureChanged();
+}
+
+void OptionSources::structureChanged()
+{
+  ++mStructureVersion;
+}
+
+void OptionSources::fieldsChanged()
+{
+  ++mFieldsVersion;
+}
+
+QVector<std::shared_ptr<NodeSaveInfo>> OptionSources::callers(const QString& constructId)
+{
+  if (!mStorage)
+    return {};
+
+  updateIndex();
+
+  // A construct never moves to another component, so the owner only has to be
+  // looked for again when it was removed
+  QString ownerId = mOwners.value(constructId);
+  if (!mComponents.contains(ownerId))
+  {
+    ownerId = findOwner(constructId);
+    if (ownerId.isEmpty())
+      return {};
+
+    mOwners.insert(constructId, ownerId);
+  }
+
+  auto family = mFamilies.constFind(ownerId);
+  if (family != mFamilies.constEnd() && family->version == mStructureVersion)
+    return family->nodes;
+
+  const Component& component = mComponents[ownerId];
+  const auto& siblings = component.parent ? component.parent->children : mStorage->structuralNodes;
+
+  Family computed{mStructureVersion, siblings + component.info->children};
+  mFamilies.insert(ownerId, computed);
+
+  return computed.nodes;
+}
+
+QVector<std::shared_ptr<FlowSaveInfo>> OptionSources::events(const QString& componentId)
+{
+  if (!mStorage)
+    return {};
+
+  updateIndex();
+
+  auto component = mComponents.constFind(componentId);
+  if (component == mComponents.constEnd())
+    return {};
+
+  return component->info->flows;
+}
+
+QVector<std::shared_ptr<NodeSaveInfo>> OptionSources::states()
+{
+  if (!mStorage)
+    return {};
+
+  if (mStatesVersion == mStructureVersion && mStatesFieldsVersion == mFieldsVersion)
+    return mStates;
+
+  mStates.clear();
+  collectStates(mStorage->structuralNodes);
+
+  mStatesVersion = mStructureVersion;
+  mStatesFieldsVersion = mFieldsVersion;
+
+  return mStates;
+}
+
+void OptionSources::updateIndex()
+{
+  if (mIndexVersion == mStructureVersion)
+    return;
+
+  mComponents.clear();
+  indexComponents(mStorage->structuralNodes, nullptr);
+  mIndexVersion = mStructureVersion;
+}
+
+void OptionSources::indexComponents(const QVector<std::shared_ptr<NodeSaveInfo>>& nodes, NodeSaveInfo* parent)
+{
+  for (const auto& node : nodes)
+  {
+    mComponents.insert(node->id, {node, parent});
+    indexComponents(node->children, node.get());
+  }
+}
+
+void OptionSources::collectStates(const QVector<std::shared_ptr<NodeSaveInfo>>& nodes)
+{
+  for (const auto& node : nodes)
+  {
+    if (!node->fields.isEmpty())
+      mStates.push_back(node);
+
+    collectStates(node->children);
+  }
+}
+
+QString OptionSources::findOwner(const QString& constructId) const
+{
+  for (const auto& component : mComponents)
+  {
+    if (ownsConstruct(*component.info, constructId))
+      return component.info->id;
+  }
+
+  return QString();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+struct FlowSaveInfo;
+struct NodeSaveInfo;
+struct SaveInfo;
+
+// Options offered by the component, event and state selectors. Walking the
+// whole save info every time a node is shown gets slow in deep systems, so the
+// results are kept per owner component and stamped with the version of the
+// structure they were computed from.
+class OptionSources
+{
+public:
+  OptionSources();
+
+  void setStorage(std::shared_ptr<SaveInfo> storage);
+
+  // Components were added or removed
+  void structureChanged();
+  // Whether a component has states depends on its fields
+  void fieldsChanged();
+
+  // Siblings and children of the component that owns the construct
+  QVector<std::shared_ptr<NodeSaveInfo>> callers(const QString& constructId);
+  // The flows of the component, read from the storage so they are always current
+  QVector<std::shared_ptr<FlowSaveInfo>> events(const QString& componentId);
+  // Components with at least one field
+  QVector<std::shared_ptr<NodeSaveInfo>> states();
+
+private:
+  struct Component
+  {
+    std::shared_ptr<NodeSaveInfo> info;
+    NodeSaveInfo* parent;
+  };
+
+  struct Family
+  {
+    quint64 version;
+    QVector<std::shared_ptr<NodeSaveInfo>> nodes;
+  };
+
+  std::shared_ptr<SaveInfo> mStorage;
+
+  quint64 mStructureVersion;
+  quint64 mFieldsVersion;
+
+  // Every structural component by id
+  quint64 mIndexVersion;
+  QHash<QString, Component> mComponents;
+
+  // Constructs by the component they belong to
+  QHash<QString, QString> mOwners;
+  QHash<QString, Family> mFamilies;
+
+  quint64 mStatesVersion;
+  quint64 mStatesFieldsVersion;
+  QVector<std::shared_ptr<NodeSaveInfo>> mStates;
+
+  void updateIndex();
+  void indexComponents(const QVector<std::shared_ptr<NodeSaveInfo>>& nodes, NodeSaveInfo* parent);
+  void collectStates(const QVector<std::shared_ptr<NodeSaveInfo>>& nodes);
+
+  QString findOwner(const QString& constructId) const;
+};
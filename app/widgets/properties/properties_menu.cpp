@@ -45,6 +45,7 @@ PropertiesMenu::PropertiesMenu(QWidget* parent)
 VoidResult PropertiesMenu::start(std::shared_ptr<SaveInfo> storage)
 {
   mStorage = storage;
+  mOptions.setStorage(storage);
   return VoidResult();
 }
 
@@ -53,18 +54,109 @@ void PropertiesMenu::clear()
   if (!layout())
     return;
 
-  // Remove and delete all child widgets
+  releaseEditors();
+
+  // Remove and delete all child widgets, pooled editors are only taken out
   while (QLayoutItem* item = layout()->takeAt(0))
   {
-    if (QWidget* widget = item->widget())
+    if (QWidget* widget = item->widget(); widget && !mPooledWidgets.contains(widget))
       widget->deleteLater();
 
     delete item;
   }
 }
 
+PropertiesMenu::PropertyEditor* PropertiesMenu::takeEditor(Types::PropertyTypes type, const QString& label)
+{
+  PropertyEditor* editor = nullptr;
+
+  auto& pool = mFreeEditors[type];
+  if (pool.isEmpty())
+    editor = createEditor(type);
+  else
+    editor = pool.takeLast();
+
+  editor->label->setText(label);
+
+  layout()->addWidget(editor->label);
+  layout()->addWidget(editor->widget);
+  editor->label->show();
+  editor->widget->show();
+
+  mActiveEditors.push_back(editor);
+
+  return editor;
+}
+
+PropertiesMenu::PropertyEditor* PropertiesMenu::createEditor(Types::PropertyTypes type)
+{
+  auto editor = std::make_unique<PropertyEditor>();
+  editor->type = type;
+
+  editor->label = new QLabel(this);
+  editor->label->setFont(Fonts::Label);
+
+  if (type == Types::PropertyTypes::BOOLEAN)
+  {
+    editor->widget = new QCheckBox(this);
+  }
+  else if (type == Types::PropertyTypes::SELECT)
+  {
+    editor->widget = new QComboBox(this);
+  }
+  else if (type == Types::PropertyTypes::COLOR)
+  {
+    editor->widget = new QWidget(this);
+    QHBoxLayout* holderLayout = new QHBoxLayout(editor->widget);
+    editor->widget->setLayout(holderLayout);
+
+    editor->preview = new QLabel(editor->widget);
+    editor->preview->setAutoFillBackground(true);
+
+    editor->button = new QPushButton(editor->widget);
+    editor->button->setFont(Fonts::Property);
+
+    holderLayout->addWidget(editor->preview);
+    holderLayout->addWidget(editor->button);
+  }
+  else
+  {
+    QLineEdit* widget = new QLineEdit(this);
+    // QIntValidator* validator = new QIntValidator(INT32_MIN, INT32_MIN, widget);
+    if (type == Types::PropertyTypes::REAL)
+      widget->setValidator(new QDoubleValidator(DBL_MIN, DBL_MAX, 6, widget));
+
+    editor->widget = widget;
+  }
+
+  editor->widget->setFont(Fonts::Property);
+
+  mPooledWidgets.insert(editor->label);
+  mPooledWidgets.insert(editor->widget);
+
+  mEditors.push_back(std::move(editor));
+  return mEditors.back().get();
+}
+
+void PropertiesMenu::releaseEditors()
+{
+  for (PropertyEditor* editor : mActiveEditors)
+  {
+    // Unbind first, a focused line edit reports editingFinished when hidden
+    disconnect(editor->binding);
+
+    editor->label->hide();
+    editor->widget->hide();
+
+    mFreeEditors[editor->type].push_back(editor);
+  }
+
+  mActiveEditors.clear();
+}
+
 VoidResult PropertiesMenu::onNodeAdded(NodeItem* /* node */)
 {
+  mOptions.structureChanged();
   return VoidResult();
 }
 
@@ -73,6 +165,8 @@ VoidResult PropertiesMenu::onNodeRemoved(NodeItem* node)
   if (!node)
     return VoidResult();
 
+  mOptions.structureChanged();
+
   // Clear the frame
   if (node->id() != mCurrentNode)
     return VoidResult();
@@ -83,8 +177,9 @@ VoidResult PropertiesMenu::onNodeRemoved(NodeItem* node)
   return VoidResult();
 }
 
-VoidResult PropertiesMenu::onNodeModified(NodeItem* node)
+VoidResult PropertiesMenu::onNodeModified(NodeItem* /* node */)
 {
+  mOptions.fieldsChanged();
   return VoidResult();
 }
 
@@ -213,23 +308,17 @@ VoidResult PropertiesMenu::loadControls(NodeItem* node)
 
 VoidResult PropertiesMenu::loadPropertyInt(const PropertiesConfig& property, NodeItem* node)
 {
-  QString label = ToLabel(property.id);
-  QLabel* nameLabel = new QLabel(label);
-
-  nameLabel->setFont(Fonts::Label);
-  layout()->addWidget(nameLabel);
-
-  QLineEdit* widget = new QLineEdit(this);
-  // QIntValidator* validator = new QIntValidator(INT32_MIN, INT32_MIN, widget);
-
   auto result = node->getProperty(property.id);
   if (!result.isValid())
     return VoidResult::Failed("Failed to get default value");
 
+  PropertyEditor* editor = takeEditor(property.type, ToLabel(property.id));
+  QLineEdit* widget = static_cast<QLineEdit*>(editor->widget);
+
   widget->setText(result.toString());
   // widget->setValidator(validator);
 
-  connect(widget, &QLineEdit::editingFinished, this, [=]() {
+  editor->binding = connect(widget, &QLineEdit::editingFinished, this, [=]() {
     bool ok;
     int newValue = widget->text().toInt(&ok);
     if (ok)
@@ -238,31 +327,21 @@ VoidResult PropertiesMenu::loadPropertyInt(const PropertiesConfig& property, Nod
       LOG_WARNING("Failed to set property of node %s to %d (%s)", qPrintable(node->nodeId()), newValue, qPrintable(widget->text()));
   });
 
-  widget->setFont(Fonts::Property);
-  layout()->addWidget(widget);
-
   return VoidResult();
 }
 
 VoidResult PropertiesMenu::loadPropertyReal(const PropertiesConfig& property, NodeItem* node)
 {
-  QString label = ToLabel(property.id);
-  QLabel* nameLabel = new QLabel(label);
-
-  nameLabel->setFont(Fonts::Label);
-  layout()->addWidget(nameLabel);
-
-  QLineEdit* widget = new QLineEdit(this);
-  QDoubleValidator* validator = new QDoubleValidator(DBL_MIN, DBL_MAX, 6, widget);
-
   auto result = node->getProperty(property.id);
   if (!result.isValid())
     return VoidResult::Failed("Failed to get default value");
 
+  PropertyEditor* editor = takeEditor(property.type, ToLabel(property.id));
+  QLineEdit* widget = static_cast<QLineEdit*>(editor->widget);
+
   widget->setText(result.toString());
-  widget->setValidator(validator);
 
-  connect(widget, &QLineEdit::returnPressed, this, [=]() {
+  editor->binding = connect(widget, &QLineEdit::returnPressed, this, [=]() {
     bool ok;
     qreal newValue = widget->text().toDouble(&ok);
     if (ok)
@@ -271,38 +350,24 @@ VoidResult PropertiesMenu::loadPropertyReal(const PropertiesConfig& property, No
       LOG_WARNING("Failed to set property. Not a valid number");
   });
 
-  widget->setFont(Fonts::Property);
-  layout()->addWidget(widget);
-
   return VoidResult();
 }
 
 VoidResult PropertiesMenu::loadPropertyColor(const PropertiesConfig& property, NodeItem* node)
 {
-  QString label = ToLabel(property.id);
-  QLabel* nameLabel = new QLabel(label);
-
-  nameLabel->setFont(Fonts::Label);
-  layout()->addWidget(nameLabel);
-
-  QWidget* holder = new QWidget(this);
-  QHBoxLayout* holderLayout = new QHBoxLayout(holder);
-  holder->setLayout(holderLayout);
-
-  QPushButton* widget = new QPushButton(this);
   auto result = node->getProperty(property.id);
   if (!result.isValid())
     return VoidResult::Failed("Failed to get default value");
 
+  PropertyEditor* editor = takeEditor(property.type, ToLabel(property.id));
+  QLabel* colorPreviewLabel = editor->preview;
+
   QColor selectedColor = QColor::fromString(result.toString());
   QPalette palette;
   palette.setColor(QPalette::Window, selectedColor);
-
-  QLabel* colorPreviewLabel = new QLabel(this);
-  colorPreviewLabel->setAutoFillBackground(true);
   colorPreviewLabel->setPalette(palette);
 
-  connect(widget, &QPushButton::pressed, [=]() {
+  editor->binding = connect(editor->button, &QPushButton::pressed, this, [=]() {
     QColor color = QColorDialog::getColor(selectedColor, this, "Background Color");
     QPalette newPalette;
     newPalette.setColor(QPalette::Window, color);
@@ -312,90 +377,71 @@ VoidResult PropertiesMenu::loadPropertyColor(const PropertiesConfig& property, N
     node->setProperty(property.id, color.name());
   });
 
-  widget->setText(result.toString());
-  widget->setFont(Fonts::Property);
-
-  holderLayout->addWidget(colorPreviewLabel);
-  holderLayout->addWidget(widget);
-
-  layout()->addWidget(holder);
+  editor->button->setText(result.toString());
 
   return VoidResult();
 }
 
 VoidResult PropertiesMenu::loadPropertySelect(const PropertiesConfig& property, NodeItem* node)
 {
-  QString label = ToLabel(property.id);
-  QLabel* nameLabel = new QLabel(label);
-
-  nameLabel->setFont(Fonts::Label);
-  layout()->addWidget(nameLabel);
-
-  QComboBox* widget = new QComboBox(this);
-
-  auto options = property.options;
-  for (const auto& option : options)
-    widget->addItem(option.id);
-
   auto result = node->getProperty(property.id);
   if (!result.isValid())
     return VoidResult::Failed("Failed to get default value");
 
+  PropertyEditor* editor = takeEditor(property.type, ToLabel(property.id));
+  QComboBox* widget = static_cast<QComboBox*>(editor->widget);
+
+  QStringList options;
+  for (const auto& option : property.options)
+    options.push_back(option.id);
+
+  // Nodes of the same kind share their options, no need to rebuild them
+  if (options != editor->options)
+  {
+    widget->clear();
+    widget->addItems(options);
+    editor->options = options;
+  }
+
   widget->setCurrentText(result.toString());
-  connect(widget, &QComboBox::currentTextChanged, this, [=](const QString& text) {
+  editor->binding = connect(widget, &QComboBox::currentTextChanged, this, [=](const QString& text) {
     node->setProperty(property.id, text);
   });
 
-  widget->setFont(Fonts::Property);
-  layout()->addWidget(widget);
-
   return VoidResult();
 }
 
 VoidResult PropertiesMenu::loadPropertyString(const PropertiesConfig& property, NodeItem* node)
 {
-  QString label = ToLabel(property.id);
-  QLabel* nameLabel = new QLabel(label);
-
-  nameLabel->setFont(Fonts::Label);
-  layout()->addWidget(nameLabel);
-
-  QLineEdit* widget = new QLineEdit(this);
   auto result = node->getProperty(property.id);
   if (!result.isValid())
     return VoidResult::Failed("Failed to get default value");
 
+  PropertyEditor* editor = takeEditor(property.type, ToLabel(property.id));
+  QLineEdit* widget = static_cast<QLineEdit*>(editor->widget);
+
   widget->setText(result.toString());
-  connect(widget, &QLineEdit::editingFinished, this, [=]() {
+  editor->binding = connect(widget, &QLineEdit::editingFinished, this, [=]() {
     node->setProperty(property.id, widget->text());
   });
 
-  widget->setFont(Fonts::Property);
-  layout()->addWidget(widget);
   return VoidResult();
 }
 
 VoidResult PropertiesMenu::loadPropertyBoolean(const PropertiesConfig& property, NodeItem* node)
 {
-  QString label = ToLabel(property.id);
-  QLabel* nameLabel = new QLabel(label);
-
-  nameLabel->setFont(Fonts::Label);
-  layout()->addWidget(nameLabel);
-
-  QCheckBox* widget = new QCheckBox(this);
   auto result = node->getProperty(property.id);
   if (!result.isValid())
     return VoidResult::Failed("Failed to get default value");
 
+  PropertyEditor* editor = takeEditor(property.type, ToLabel(property.id));
+  QCheckBox* widget = static_cast<QCheckBox*>(editor->widget);
+
   widget->setChecked(result.toBool());
-  connect(widget, &QCheckBox::checkStateChanged, this, [=](Qt::CheckState state) {
+  editor->binding = connect(widget, &QCheckBox::checkStateChanged, this, [=](Qt::CheckState state) {
     node->setProperty(property.id, state);
   });
 
-  widget->setFont(Fonts::Property);
-  layout()->addWidget(widget);
-
   return VoidResult();
 }
 
@@ -414,7 +460,7 @@ VoidResult PropertiesMenu::loadPropertyStateSelect(const PropertiesConfig& prope
   QComboBox* widget = new QComboBox(this);
   widget->setObjectName(property.id);
 
-  auto callers = mStorage->getPossibleCallers(node->id());
+  auto callers = mOptions.callers(node->id());
   for (const auto& caller : callers)
   {
     auto callerName = caller->properties[ConfigKeys::NAME].toString();
@@ -506,7 +552,7 @@ void PropertiesMenu::addStateAssignment(const PropertiesConfig& property, int in
   QComboBox* widget = new QComboBox(group);
   widget->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
 
-  auto callers = mStorage->getPossibleStates(node->id());
+  auto callers = mOptions.states();
   for (const auto& caller : callers)
   {
     QString callerName = "";
@@ -597,7 +643,7 @@ VoidResult PropertiesMenu::loadPropertyComponentSelect(const PropertiesConfig& p
   QComboBox* widget = new QComboBox(this);
   widget->setObjectName(property.id);
 
-  for (const auto& child : mStorage->getPossibleCallers(node->id()))
+  for (const auto& child : mOptions.callers(node->id()))
   {
     auto name = child->properties[ConfigKeys::NAME];
     if (name.isNull() || !name.isValid())
@@ -645,7 +691,7 @@ VoidResult PropertiesMenu::loadPropertyComponentSelect(const PropertiesConfig& p
           QJsonObject object = value.toJsonObject();
           widget->setCurrentText(object[ConfigKeys::DATA].toString());
 
-          auto events = mStorage->getEventsFromNode(widget->currentData().toString());
+          auto events = mOptions.events(widget->currentData().toString());
           for (const auto& event : events)
             eventWidget->addItem(event->name, event->id);
 
@@ -686,7 +732,7 @@ VoidResult PropertiesMenu::loadPropertyComponentSelect(const PropertiesConfig& p
             return;
 
           eventWidget->clear();
-          auto events = mStorage->getEventsFromNode(widget->currentData().toString());
+          auto events = mOptions.events(widget->currentData().toString());
           for (const auto& event : events)
             eventWidget->addItem(event->name, event->id);
 
@@ -879,14 +925,14 @@ VoidResult PropertiesMenu::onTransitionSelected(TransitionItem* transition)
   layout()->addWidget(comboLabel);
 
   QComboBox* eventWidget = new QComboBox(this);
-  auto callers = mStorage->getPossibleCallers(source->id());
+  auto callers = mOptions.callers(source->id());
   for (const auto& caller : callers)
   {
     auto name = caller->properties[ConfigKeys::NAME];
     if (name.isNull() || !name.isValid())
       continue;
 
-    auto events = mStorage->getEventsFromNode(caller->id);
+    auto events = mOptions.events(caller->id);
     for (const auto& event : events)
       eventWidget->addItem(name.toString() + "." + event->name, event->id);
 
@@ -3,16 +3,24 @@
 #include <qtmetamacros.h>
 
 #include <QFrame>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <memory>
+#include <vector>
 
 #include "../menu_base.h"
 #include "config.h"
+#include "option_sources.h"
 #include "result.h"
 
 class Flow;
 class NodeItem;
 class SaveInfo;
+class QLabel;
 class QLineEdit;
 class QComboBox;
+class QPushButton;
 class QTableView;
 class QHBoxLayout;
 class FlowSaveInfo;
@@ -45,12 +53,39 @@ signals:
   void flowRemoved(const QString& flowId, const QString& nodeId);
 
 private:
+  // A label and an editor for one of the plain property types, rebound to
+  // whichever node is selected instead of being built again on every click
+  struct PropertyEditor
+  {
+    Types::PropertyTypes type;
+    QLabel* label = nullptr;
+    QWidget* widget = nullptr;
+
+    // Colors show a preview next to the button that opens the dialog
+    QLabel* preview = nullptr;
+    QPushButton* button = nullptr;
+
+    // Items currently in a select, so they are only replaced when they differ
+    QStringList options;
+    QMetaObject::Connection binding;
+  };
+
   QString mCurrentNode;
   QDialog* mCurrentDialog;
   std::shared_ptr<SaveInfo> mStorage;
+  OptionSources mOptions;
+
+  std::vector<std::unique_ptr<PropertyEditor>> mEditors;
+  QMap<Types::PropertyTypes, QVector<PropertyEditor*>> mFreeEditors;
+  QVector<PropertyEditor*> mActiveEditors;
+  QSet<QWidget*> mPooledWidgets;
 
   void clear();
 
+  PropertyEditor* takeEditor(Types::PropertyTypes type, const QString& label);
+  PropertyEditor* createEditor(Types::PropertyTypes type);
+  void releaseEditors();
+
   // Property related actions
   VoidResult loadProperties(NodeItem* node);
   VoidResult loadPropertyInt(const PropertiesConfig& property, NodeItem* node);
@@ -90,11 +90,22 @@ VoidResult SettingsDialog::createGeneralPage()
   mConfirmOnClose = new QCheckBox(tr("Confirm before closing editor with running execution"), page);
   mEnableDebugLogs = new QCheckBox(tr("Enable debug logs"), page);
 
+  mFlowTabItemBudget = new QSpinBox(page);
+  mFlowTabItemBudget->setRange(0, 1000000);
+  mFlowTabItemBudget->setSingleStep(1000);
+  mFlowTabItemBudget->setSuffix(tr(" items"));
+
+  auto flowBudgetLayout = new QHBoxLayout;
+  flowBudgetLayout->addWidget(new QLabel(tr("Inactive flow tabs budget:"), page));
+  flowBudgetLayout->addWidget(mFlowTabItemBudget);
+  flowBudgetLayout->addStretch();
+
   static_cast<QVBoxLayout*>(page->layout())->addWidget(mRestoreLastSession);
   static_cast<QVBoxLayout*>(page->layout())->addWidget(mAutosaveEnabled);
   static_cast<QVBoxLayout*>(page->layout())->addLayout(autosaveLayout);
   static_cast<QVBoxLayout*>(page->layout())->addWidget(mConfirmOnClose);
   static_cast<QVBoxLayout*>(page->layout())->addWidget(mEnableDebugLogs);
+  static_cast<QVBoxLayout*>(page->layout())->addLayout(flowBudgetLayout);
   static_cast<QVBoxLayout*>(page->layout())->addStretch();
 
   return VoidResult();
@@ -168,6 +179,7 @@ void SettingsDialog::loadFromSettings()
   mAutosaveMinutes->setValue(g.autosaveIntervalMinutes);
   mConfirmOnClose->setChecked(g.confirmOnCloseWithExecution);
   mEnableDebugLogs->setChecked(g.enableDebugLogs);
+  mFlowTabItemBudget->setValue(g.flowTabItemBudget);
 
   int themeIndex = mThemeCombo->findData(a.theme);
   if (themeIndex < 0)
@@ -188,6 +200,7 @@ void SettingsDialog::saveToSettings()
   g.autosaveIntervalMinutes = mAutosaveMinutes->value();
   g.confirmOnCloseWithExecution = mConfirmOnClose->isChecked();
   g.enableDebugLogs = mEnableDebugLogs->isChecked();
+  g.flowTabItemBudget = mFlowTabItemBudget->value();
 
   AppearanceSettings a;
   a.uiScalePercent = mUiScale->value();
@@ -37,6 +37,7 @@ private:
   QSpinBox* mAutosaveMinutes = nullptr;
   QCheckBox* mConfirmOnClose = nullptr;
   QCheckBox* mEnableDebugLogs = nullptr;
+  QSpinBox* mFlowTabItemBudget = nullptr;
 
   // Appearance
   QComboBox* mThemeCombo = nullptr;
@@ -36,6 +36,7 @@ void SettingsManager::load()
   mGeneral.autosaveIntervalMinutes = mSettings.value("autosaveIntervalMinutes", mGeneral.autosaveIntervalMinutes).toInt();
   mGeneral.confirmOnCloseWithExecution = mSettings.value("confirmOnCloseWithExecution", mGeneral.confirmOnCloseWithExecution).toBool();
   mGeneral.enableDebugLogs = mSettings.value("enableDebugLogs", mGeneral.enableDebugLogs).toBool();
+  mGeneral.flowTabItemBudget = mSettings.value("flowTabItemBudget", mGeneral.flowTabItemBudget).toInt();
   mSettings.endGroup();
 
   mSettings.beginGroup("Appearance");
@@ -54,6 +55,7 @@ void SettingsManager::save()
   mSettings.setValue("autosaveIntervalMinutes", mGeneral.autosaveIntervalMinutes);
   mSettings.setValue("confirmOnCloseWithExecution", mGeneral.confirmOnCloseWithExecution);
   mSettings.setValue("enableDebugLogs", mGeneral.enableDebugLogs);
+  mSettings.setValue("flowTabItemBudget", mGeneral.flowTabItemBudget);
   mSettings.endGroup();
 
   mSettings.beginGroup("Appearance");
@@ -70,6 +72,8 @@ void SettingsManager::setGeneral(const GeneralSettings& s)
 {
   mGeneral = s;
   save();
+
+  emit generalChanged(mGeneral);
 }
 
 void SettingsManager::setAppearance(const AppearanceSettings& s)
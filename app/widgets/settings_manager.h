@@ -18,6 +18,7 @@ struct GeneralSettings
   int autosaveIntervalMinutes = 5;
   bool confirmOnCloseWithExecution = true;
   bool enableDebugLogs = true;
+  int flowTabItemBudget = 5000;  // Items kept alive by inactive flow tabs
 };
 
 struct AppearanceSettings
@@ -46,6 +47,7 @@ public:
 
 signals:
   void themeChanged(const QString& theme, const QList<Config::ThemeInfo>& availableThemes);
+  void generalChanged(const GeneralSettings& settings);
 
 private:
   QSettings mSettings;
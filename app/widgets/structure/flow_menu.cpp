@@ -38,11 +38,7 @@ Result<Flow*> FlowMenu::addComponentFlow(NodeItem* node, const QString& flowName
   }
   else
   {
-    QTreeWidgetItem* newNode = new QTreeWidgetItem(componentFlows());
-    newNode->setText(NAME_INDEX, node->nodeName());
-    newNode->setData(ID_DATA, Qt::UserRole, node->id());
-    newNode->setData(TYPE_DATA, Qt::UserRole, Roles::ComponentRole);
-
+    QTreeWidgetItem* newNode = createItem(componentFlows(), node->nodeName(), node->id(), Roles::ComponentRole);
     newFlow = new QTreeWidgetItem(newNode);
   }
 
@@ -76,33 +72,13 @@ VoidResult FlowMenu::onFlowAdded(Flow* flow, NodeItem* node)
     return VoidResult();
 
   auto parent = getItemById(node->id());
-  QTreeWidgetItem* newFlow = nullptr;
-  if (parent)
-  {
-    newFlow = new QTreeWidgetItem(parent);
-  }
-  else
-  {
-    QTreeWidgetItem* newNode = new QTreeWidgetItem(componentFlows());
-    newNode->setText(NAME_INDEX, node->nodeName());
-    newNode->setData(ID_DATA, Qt::UserRole, node->id());
-    newNode->setData(TYPE_DATA, Qt::UserRole, Roles::ComponentRole);
+  if (!parent)
+    parent = createItem(componentFlows(), node->nodeName(), node->id(), Roles::ComponentRole);
 
-    newFlow = new QTreeWidgetItem(newNode);
-  }
-
-  // Assign the tree information
-  newFlow->setText(NAME_INDEX, flow->name());
-  newFlow->setData(ID_DATA, Qt::UserRole, flow->id());
-  newFlow->setData(TYPE_DATA, Qt::UserRole, Roles::FlowRole);
+  QTreeWidgetItem* newFlow = createItem(parent, flow->name(), flow->id(), Roles::FlowRole);
 
   for (const auto& component : flow->getNodes())
-  {
-    QTreeWidgetItem* newComponent = new QTreeWidgetItem(newFlow);
-    newComponent->setText(NAME_INDEX, component->properties["name"].toString());
-    newComponent->setData(ID_DATA, Qt::UserRole, component->id);
-    newComponent->setData(TYPE_DATA, Qt::UserRole, Roles::NodeRole);
-  }
+    createItem(newFlow, component->properties["name"].toString(), component->id, Roles::NodeRole);
 
   return VoidResult();
 }
@@ -117,11 +93,13 @@ VoidResult FlowMenu::onFlowRemoved(const QString& flowId, NodeItem* node)
   if (flowItem == nullptr)
     return VoidResult::Failed("No flow to delete");
 
+  forgetItem(flowItem);
   nodeItem->removeChild(flowItem);
   delete flowItem;
 
   if (nodeItem->childCount() == 0)
   {
+    forgetItem(nodeItem);
     componentFlows()->removeChild(nodeItem);
     delete nodeItem;
   }
@@ -137,10 +115,22 @@ VoidResult FlowMenu::onNodeAdded(const QString& flowId, NodeItem* node)
     return VoidResult::Failed("Could not add node, no such flow");
 
   // Add item to the tree
-  QTreeWidgetItem* newNode = new QTreeWidgetItem(parent);
-  newNode->setText(NAME_INDEX, node->nodeName());
-  newNode->setData(ID_DATA, Qt::UserRole, node->id());
-  newNode->setData(TYPE_DATA, Qt::UserRole, Roles::NodeRole);
+  createItem(parent, node->nodeName(), node->id(), Roles::NodeRole);
+
+  return VoidResult();
+}
+
+VoidResult FlowMenu::onNodesAdded(const QString& flowId, const QList<NodeItem*>& nodes)
+{
+  auto parent = getItemById(flowId);
+  if (parent == nullptr)
+    return VoidResult::Failed("Could not add nodes, no such flow");
+
+  QList<QTreeWidgetItem*> items;
+  for (NodeItem* node : nodes)
+    items.push_back(createItem(nullptr, node->nodeName(), node->id(), Roles::NodeRole));
+
+  parent->addChildren(items);
 
   return VoidResult();
 }
@@ -158,7 +148,9 @@ VoidResult FlowMenu::onNodeRemoved(const QString& flowId, NodeItem* node)
   if (component->data(TYPE_DATA, Qt::UserRole) != Roles::NodeRole)
     return VoidResult::Failed("Item is in the tree but it is not a node");
 
+  forgetItem(component);
   flow->removeChild(component);
+  delete component;
 
   return VoidResult();
 }
@@ -179,15 +171,32 @@ VoidResult FlowMenu::onNodeSelected(const QString& flowId, NodeItem* node, bool
   return VoidResult();
 }
 
-QTreeWidgetItem* FlowMenu::getItemById(const QString& id)
+QTreeWidgetItem* FlowMenu::createItem(QTreeWidgetItem* parent, const QString& name, const QString& id, Roles role)
 {
-  for (QTreeWidgetItemIterator it(this); *it; ++it)
-  {
-    if ((*it)->data(ID_DATA, Qt::UserRole).toString() == id)
-      return *it;
-  }
+  // Without a parent the caller adds it to the tree
+  QTreeWidgetItem* item = parent ? new QTreeWidgetItem(parent) : new QTreeWidgetItem();
+  item->setText(NAME_INDEX, name);
+  item->setData(ID_DATA, Qt::UserRole, id);
+  item->setData(TYPE_DATA, Qt::UserRole, role);
+
+  mItems.insert(id, item);
+
+  return item;
+}
+
+QTreeWidgetItem* FlowMenu::getItemById(const QString& id) const
+{
+  return mItems.value(id, nullptr);
+}
+
+void FlowMenu::forgetItem(QTreeWidgetItem* item)
+{
+  auto id = item->data(ID_DATA, Qt::UserRole).toString();
+  if (mItems.value(id, nullptr) == item)
+    mItems.remove(id);
 
-  return nullptr;
+  for (int i = 0; i < item->childCount(); ++i)
+    forgetItem(item->child(i));
 }
 
 void FlowMenu::showContextMenu(const QPoint& pos)
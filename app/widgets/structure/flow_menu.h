@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QTreeWidget>
 
 #include "../menu_base.h"
@@ -21,6 +22,7 @@ public:
   VoidResult onFlowRemoved(const QString& flowId, NodeItem* node);
 
   VoidResult onNodeAdded(const QString& flowId, NodeItem* node);
+  VoidResult onNodesAdded(const QString& flowId, const QList<NodeItem*>& nodes);
   VoidResult onNodeRemoved(const QString& flowId, NodeItem* node);
   VoidResult onNodeModified(const QString& flowId, NodeItem* node);
   VoidResult onNodeSelected(const QString& flowId, NodeItem* node, bool selected);
@@ -48,7 +50,12 @@ private:
   QTreeWidgetItem* systemFlows();
   QTreeWidgetItem* componentFlows();
 
-  QTreeWidgetItem* getItemById(const QString& id);
+  // Components, flows and nodes by id, kept in sync on add and remove
+  QHash<QString, QTreeWidgetItem*> mItems;
+
+  QTreeWidgetItem* createItem(QTreeWidgetItem* parent, const QString& name, const QString& id, Roles role);
+  QTreeWidgetItem* getItemById(const QString& id) const;
+  void forgetItem(QTreeWidgetItem* item);
 
   void editFlow(QTreeWidgetItem* item);
   void removeFlow(QTreeWidgetItem* item);
@@ -1,23 +1,28 @@
 #pragma once
 
-#include <QTreeWidget>
+#include <QTreeView>
+#include <memory>
 
 #include "../menu_base.h"
 #include "result.h"
 
 class NodeItem;
-class QTreeWidgetItem;
+class SystemModel;
+struct SaveInfo;
 
-class SystemMenu : public QTreeWidget, public MenuBase
+class SystemMenu : public QTreeView, public MenuBase
 {
   Q_OBJECT
 public:
   SystemMenu(QWidget* parent);
 
+  void start(std::shared_ptr<SaveInfo> storage);
+
   VoidResult onNodeAdded(NodeItem* node) override;
   VoidResult onNodeRemoved(NodeItem* node) override;
   VoidResult onNodeModified(NodeItem* node) override;
   VoidResult onNodeSelected(NodeItem* node, bool selected) override;
+  VoidResult onNodesAdded(const QList<NodeItem*>& nodes) override;
 
 signals:
   void nodeFocused(const QString& nodeId);
@@ -29,13 +34,9 @@ signals:
 
 private slots:
   void showContextMenu(const QPoint& pos);
-  void onItemClicked(QTreeWidgetItem* item, int /* column */);
+  void onItemClicked(const QModelIndex& index);
   void onSelectionChanged();
 
 private:
-  VoidResult addRootNode(NodeItem* node);
-  VoidResult addLeafNode(NodeItem* node);
-
-  void populateItem(QTreeWidgetItem* item, NodeItem* node);
-  QTreeWidgetItem* getItemById(const QString& id);
+  SystemModel* mModel;
 };
@@ -0,0 +1,254 @@
+#include "system_model.h"
+
+#include "elements/node.h"
+#include "elements/save_info.h"
+
+// Rows handed to the view at once when a parent is expanded or scrolled
+static const int FETCH_BATCH = 500;
+
+SystemModel::SystemModel(QObject* parent)
+    : QAbstractItemModel(parent)
+    , mRoot(std::make_unique<Entry>())
+{
+}
+
+SystemModel::~SystemModel() = default;
+
+void SystemModel::setStorage(std::shared_ptr<SaveInfo> storage)
+{
+  mStorage = storage;
+  reload();
+}
+
+void SystemModel::reload()
+{
+  beginResetModel();
+  mEntries.clear();
+  mRoot = std::make_unique<Entry>();
+  endResetModel();
+}
+
+VoidResult SystemModel::insertNode(NodeItem* node)
+{
+  Entry* parent = mRoot.get();
+  auto parentNode = static_cast<NodeItem*>(node->parentNode());
+  if (parentNode)
+  {
+    // Never shown, the node is read from the save info when the parent is expanded
+    parent = mEntries.value(parentNode->id(), nullptr);
+    if (!parent)
+      return VoidResult();
+  }
+
+  auto nodes = source(parent);
+  if (!nodes)
+    return VoidResult::Failed("The model has no storage");
+
+  // New nodes are appended, so look from the back
+  int row = nodes->lastIndexOf(node->storage());
+  if (row < 0)
+    return VoidResult::Failed("Node is not in the storage");
+
+  // Past the fetched rows, it comes with the next fetch
+  if (row > static_cast<int>(parent->children.size()))
+    return VoidResult();
+
+  beginInsertRows(indexOf(parent), row, row);
+  addEntry(parent, row, node->storage());
+  endInsertRows();
+
+  return VoidResult();
+}
+
+VoidResult SystemModel::insertNodes(const QList<NodeItem*>& nodes)
+{
+  // Cheaper to let the view fetch what it shows than to announce every node
+  if (nodes.size() > FETCH_BATCH)
+  {
+    reload();
+    return VoidResult();
+  }
+
+  for (NodeItem* node : nodes)
+    RETURN_ON_FAILURE(insertNode(node));
+
+  return VoidResult();
+}
+
+VoidResult SystemModel::removeNode(NodeItem* node)
+{
+  Entry* removed = mEntries.value(node->id(), nullptr);
+  if (!removed)
+    return VoidResult();
+
+  // The node is already gone from the save info, only the entries are used here
+  Entry* parent = removed->parent;
+  int row = removed->row;
+
+  beginRemoveRows(indexOf(parent), row, row);
+  forget(removed);
+  parent->children.erase(parent->children.begin() + row);
+  renumber(parent, row);
+  endRemoveRows();
+
+  return VoidResult();
+}
+
+VoidResult SystemModel::updateNode(NodeItem* node)
+{
+  Entry* modified = mEntries.value(node->id(), nullptr);
+  if (!modified)
+    return VoidResult();
+
+  emit dataChanged(createIndex(modified->row, NameColumn, modified), createIndex(modified->row, ColumnCount - 1, modified));
+
+  return VoidResult();
+}
+
+QModelIndex SystemModel::index(int row, int column, const QModelIndex& parent) const
+{
+  Entry* p = entry(parent);
+  if (row < 0 || row >= static_cast<int>(p->children.size()) || column < 0 || column >= ColumnCount)
+    return QModelIndex();
+
+  return createIndex(row, column, p->children[row].get());
+}
+
+QModelIndex SystemModel::parent(const QModelIndex& child) const
+{
+  if (!child.isValid())
+    return QModelIndex();
+
+  return indexOf(static_cast<Entry*>(child.internalPointer())->parent);
+}
+
+int SystemModel::rowCount(const QModelIndex& parent) const
+{
+  if (parent.column() > 0)
+    return 0;
+
+  return entry(parent)->children.size();
+}
+
+int SystemModel::columnCount(const QModelIndex& /* parent */) const
+{
+  return ColumnCount;
+}
+
+bool SystemModel::hasChildren(const QModelIndex& parent) const
+{
+  if (parent.column() > 0)
+    return false;
+
+  // Answered without fetching, so the view can draw the expand arrow
+  Entry* e = entry(parent);
+  auto nodes = source(e);
+  return !e->children.empty() || (nodes && !nodes->isEmpty());
+}
+
+QVariant SystemModel::data(const QModelIndex& index, int role) const
+{
+  if (!index.isValid())
+    return QVariant();
+
+  const auto& info = static_cast<Entry*>(index.internalPointer())->info;
+  if (role == IdRole)
+    return info->id;
+
+  if (role != Qt::DisplayRole && role != Qt::ToolTipRole)
+    return QVariant();
+
+  if (index.column() == NameColumn)
+    return info->properties.value("name").toString();
+
+  // This should also contain the library to make it unique
+  return info->nodeId;
+}
+
+QVariant SystemModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    return QVariant();
+
+  if (section == NameColumn)
+    return tr("Name");
+  if (section == TypeColumn)
+    return tr("Type");
+
+  return QVariant();
+}
+
+bool SystemModel::canFetchMore(const QModelIndex& parent) const
+{
+  if (parent.column() > 0)
+    return false;
+
+  Entry* e = entry(parent);
+  auto nodes = source(e);
+  return nodes && static_cast<int>(e->children.size()) < nodes->size();
+}
+
+void SystemModel::fetchMore(const QModelIndex& parent)
+{
+  if (!canFetchMore(parent))
+    return;
+
+  Entry* e = entry(parent);
+  auto nodes = source(e);
+
+  int first = e->children.size();
+  int last = qMin(nodes->size(), first + FETCH_BATCH) - 1;
+
+  beginInsertRows(parent, first, last);
+  for (int row = first; row <= last; ++row)
+    addEntry(e, row, nodes->at(row));
+  endInsertRows();
+}
+
+SystemModel::Entry* SystemModel::entry(const QModelIndex& index) const
+{
+  if (!index.isValid())
+    return mRoot.get();
+
+  return static_cast<Entry*>(index.internalPointer());
+}
+
+QModelIndex SystemModel::indexOf(Entry* entry) const
+{
+  if (!entry || entry == mRoot.get())
+    return QModelIndex();
+
+  return createIndex(entry->row, NameColumn, entry);
+}
+
+const QVector<std::shared_ptr<NodeSaveInfo>>* SystemModel::source(const Entry* entry) const
+{
+  if (entry == mRoot.get())
+    return mStorage ? &mStorage->structuralNodes : nullptr;
+
+  return &entry->info->children;
+}
+
+void SystemModel::addEntry(Entry* parent, int row, std::shared_ptr<NodeSaveInfo> info)
+{
+  auto added = std::make_unique<Entry>();
+  added->info = info;
+  added->parent = parent;
+
+  mEntries.insert(info->id, added.get());
+  parent->children.insert(parent->children.begin() + row, std::move(added));
+  renumber(parent, row);
+}
+
+void SystemModel::renumber(Entry* parent, int from)
+{
+  for (int row = from; row < static_cast<int>(parent->children.size()); ++row)
+    parent->children[row]->row = row;
+}
+
+void SystemModel::forget(Entry* entry)
+{
+  mEntries.remove(entry->info->id);
+  for (const auto& child : entry->children)
+    forget(child.get());
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QList>
+#include <memory>
+#include <vector>
+
+#include "result.h"
+
+class NodeItem;
+struct NodeSaveInfo;
+struct SaveInfo;
+
+// Tree of the structural nodes, read straight from the save info. Children are
+// only fetched when their parent is expanded, so nodes that were never shown
+// cost nothing. Changes must be reported after they reach the save info.
+class SystemModel : public QAbstractItemModel
+{
+  Q_OBJECT
+public:
+  enum Columns
+  {
+    NameColumn = 0,
+    TypeColumn,
+    ColumnCount
+  };
+
+  static const int IdRole = Qt::UserRole;
+
+  SystemModel(QObject* parent = nullptr);
+  ~SystemModel();
+
+  void setStorage(std::shared_ptr<SaveInfo> storage);
+  // Forgets everything fetched so far and starts again from the save info
+  void reload();
+
+  VoidResult insertNode(NodeItem* node);
+  VoidResult insertNodes(const QList<NodeItem*>& nodes);
+  VoidResult removeNode(NodeItem* node);
+  VoidResult updateNode(NodeItem* node);
+
+  QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+  QModelIndex parent(const QModelIndex& child) const override;
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
+
+private:
+  // Fetched children are always the first ones of their parent in the save info
+  struct Entry
+  {
+    std::shared_ptr<NodeSaveInfo> info;  // Empty for the root
+    Entry* parent = nullptr;
+    int row = 0;
+    std::vector<std::unique_ptr<Entry>> children;
+  };
+
+  std::shared_ptr<SaveInfo> mStorage;
+  std::unique_ptr<Entry> mRoot;
+  // Fetched entries by node id
+  QHash<QString, Entry*> mEntries;
+
+  Entry* entry(const QModelIndex& index) const;
+  QModelIndex indexOf(Entry* entry) const;
+  const QVector<std::shared_ptr<NodeSaveInfo>>* source(const Entry* entry) const;
+
+  void addEntry(Entry* parent, int row, std::shared_ptr<NodeSaveInfo> info);
+  void renumber(Entry* parent, int from);
+  void forget(Entry* entry);
+};
@@ -0,0 +1,124 @@
+#include "verification_panel.h"
+
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QLabel>
+#include <QSplitter>
+#include <QTextBrowser>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "app_configs.h"
+#include "theme.h"
+
+enum Columns
+{
+  MODEL = 0,
+  STATUS
+};
+
+VerificationPanel::VerificationPanel(VerificationScheduler* scheduler, QWidget* parent)
+    : QWidget(parent)
+{
+  QVBoxLayout* layout = new QVBoxLayout(this);
+  layout->setContentsMargins(0, 0, 0, 0);
+
+  mSummary = new QLabel(scheduler->isAvailable() ? tr("No verification run yet") : tr("dzn was not found in the PATH"), this);
+  layout->addWidget(mSummary);
+
+  QSplitter* splitter = new QSplitter(Qt::Horizontal, this);
+  layout->addWidget(splitter);
+
+  mResults = new QTreeWidget(splitter);
+  mResults->setHeaderLabels({tr("Model"), tr("Result")});
+  mResults->setRootIsDecorated(false);
+  mResults->header()->setSectionResizeMode(MODEL, QHeaderView::Stretch);
+
+  mOutput = new QTextBrowser(splitter);
+  mOutput->setFont(Fonts::MonoSpace);
+
+  connect(mResults, &QTreeWidget::currentItemChanged, this, [this](QTreeWidgetItem* current) {
+    mOutput->setPlainText(current ? current->data(STATUS, Qt::UserRole).toString() : QString());
+  });
+
+  connect(scheduler, &VerificationScheduler::started, this, &VerificationPanel::onStarted);
+  connect(scheduler, &VerificationScheduler::jobQueued, this, &VerificationPanel::onJobQueued);
+  connect(scheduler, &VerificationScheduler::jobStarted, this, &VerificationPanel::onJobStarted);
+  connect(scheduler, &VerificationScheduler::jobFinished, this, &VerificationPanel::onJobFinished);
+  connect(scheduler, &VerificationScheduler::allFinished, this, &VerificationPanel::onAllFinished);
+}
+
+QTreeWidgetItem* VerificationPanel::itemFor(const QString& file)
+{
+  QTreeWidgetItem* item = mItems.value(file, nullptr);
+  if (item)
+    return item;
+
+  item = new QTreeWidgetItem(mResults);
+  item->setText(MODEL, QFileInfo(file).fileName());
+  item->setToolTip(MODEL, file);
+  mItems.insert(file, item);
+
+  return item;
+}
+
+void VerificationPanel::onStarted()
+{
+  // A new request starts from a clean list
+  mResults->clear();
+  mItems.clear();
+  mOutput->clear();
+  mSummary->setText(tr("Verifying..."));
+}
+
+void VerificationPanel::onJobQueued(const QString& file)
+{
+  itemFor(file)->setText(STATUS, tr("Queued"));
+}
+
+void VerificationPanel::onJobStarted(const QString& file)
+{
+  itemFor(file)->setText(STATUS, tr("Running"));
+}
+
+void VerificationPanel::onJobFinished(const QString& file, VerificationScheduler::Outcome outcome, const QString& output, bool cached)
+{
+  QTreeWidgetItem* item = itemFor(file);
+
+  QString status;
+  switch (outcome)
+  {
+    case VerificationScheduler::Outcome::Passed:
+      status = tr("Passed");
+      break;
+    case VerificationScheduler::Outcome::Failed:
+      status = tr("Failed");
+      break;
+    case VerificationScheduler::Outcome::Error:
+      status = tr("Error/Timed out");
+      break;
+  }
+
+  if (cached)
+    status += tr(" (cached)");
+
+  // Colors follow the theme, failures are the ones that need attention
+  item->setText(STATUS, status);
+  item->setForeground(STATUS, outcome == VerificationScheduler::Outcome::Failed ? Config::HIGHLIGHT : Config::FOREGROUND);
+  item->setData(STATUS, Qt::UserRole, output);
+
+  QFont font = item->font(STATUS);
+  font.setItalic(outcome == VerificationScheduler::Outcome::Error);
+  item->setFont(STATUS, font);
+
+  if (item == mResults->currentItem())
+    mOutput->setPlainText(output);
+}
+
+void VerificationPanel::onAllFinished(int passed, int failed, int errors)
+{
+  if (errors > 0)
+    mSummary->setText(tr("%1 passed, %2 failed, %3 could not be verified").arg(passed).arg(failed).arg(errors));
+  else
+    mSummary->setText(tr("%1 passed, %2 failed").arg(passed).arg(failed));
+}
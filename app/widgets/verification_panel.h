@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QHash>
+#include <QWidget>
+
+#include "system/verification_scheduler.h"
+
+class QLabel;
+class QTextBrowser;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+// Per model results of the Dezyne verification
+class VerificationPanel : public QWidget
+{
+  Q_OBJECT
+public:
+  VerificationPanel(VerificationScheduler* scheduler, QWidget* parent = nullptr);
+
+private slots:
+  void onStarted();
+  void onJobQueued(const QString& file);
+  void onJobStarted(const QString& file);
+  void onJobFinished(const QString& file, VerificationScheduler::Outcome outcome, const QString& output, bool cached);
+  void onAllFinished(int passed, int failed, int errors);
+
+private:
+  QLabel* mSummary;
+  QTreeWidget* mResults;
+  QTextBrowser* mOutput;
+
+  QHash<QString, QTreeWidgetItem*> mItems;
+
+  QTreeWidgetItem* itemFor(const QString& file);
+};